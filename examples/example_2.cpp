@@ -1,3 +1,4 @@
+#include <array>
 #include <iostream>
 #include <lexer.hpp>
 
@@ -7,6 +8,7 @@ enum class TokenKind {
     SemiColon,
     EndCharacter,
     Number,
+    Text,
     Unknown,
     Eof
 };
@@ -14,9 +16,16 @@ enum class TokenKind {
 struct LexerConfig {
     using kind_t = TokenKind;
 
+    // Outside an escape sequence only these bytes start a token; everything
+    // else, digits and 'm' included, is emitted as a single `Text` span.
+    // Introducers therefore cannot start with a digit: a "27[" form would
+    // need '2' as a trigger, which would open a sequence inside "42" too.
+    static constexpr std::string_view text_triggers = "\x1b\\";
+    // The sequence is lexed normally until its final 'm'.
+    static constexpr auto sequence_terminators = std::array{ TokenKind::EndCharacter };
+
     static constexpr auto punctuations = dark::detail::Switch<
         dark::detail::Case(TokenKind::EscapeSequence, "\\x1b["),
-        dark::detail::Case(TokenKind::EscapeSequence, "27["),
         dark::detail::Case(TokenKind::EscapeSequence, "\\033["),
         dark::detail::Case(TokenKind::Colon, ":"),
         dark::detail::Case(TokenKind::SemiColon, ";"),
@@ -41,6 +50,7 @@ constexpr std::string_view to_string(TokenKind kind) noexcept {
         case TokenKind::SemiColon: return "SemiColon";
         case TokenKind::EndCharacter: return "EndCharacter";
         case TokenKind::Number: return "Number";
+        case TokenKind::Text: return "Text";
         case TokenKind::Unknown: return "Unknown";
         case TokenKind::Eof: return "Eof";
         }
@@ -49,7 +59,8 @@ constexpr std::string_view to_string(TokenKind kind) noexcept {
 
 int main() {
     using dark::to_string;
-    std::string_view source = R"(\x1b[1;31m)";
+    std::string_view source = R"(\x1b[1;31mI'm at room 42; see map 3:1\x1b[0m
+more text)";
     
     auto lexer = dark::Lexer<LexerConfig>(source);
     auto tokens = lexer.lex();
@@ -63,7 +74,13 @@ int main() {
     // SemiColon > ';', (0, 6)
     // Number > '31', (0, 7)
     // EndCharacter > 'm', (0, 9)
-    // Eof > '', (0, 10)
+    // Text > 'I'm at room 42; see map 3:1', (0, 10)
+    // EscapeSequence > '\x1b[', (0, 37)
+    // Number > '0', (0, 42)
+    // EndCharacter > 'm', (0, 43)
+    // Text > '
+    // more text', (1, 0)
+    // Eof > '', (1, 10)
 
     return 0;
 }
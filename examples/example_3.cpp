@@ -0,0 +1,23 @@
+#include <iostream>
+#include <lexer/pipeline.hpp>
+
+
+int main() {
+    std::string_view source = R"(
+        int main() {
+            int a = 3;
+            int b = 2;
+            int c = b * a + 4;
+        }
+    )";
+
+    // Lexing runs on a background thread; tokens are streamed back in
+    // batches of 8 while the loop below consumes them.
+    auto lexer = dark::PipelinedLexer<dark::DefaultLexerConfig, 8>(source);
+
+    for (auto const& t: lexer) {
+        std::cout << dark::to_string(t.kind) << " > '" << t.text << "', (" << t.line << ", " << t.col << ")\n"; 
+    }
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+#include <filesystem>
+#include <iostream>
+#include <lexer/parallel.hpp>
+#include <vector>
+
+
+int main(int argc, char** argv) {
+    std::vector<std::filesystem::path> paths(argv + 1, argv + argc);
+    
+    auto lexer = dark::ParallelLexer<>();
+    auto result = lexer.lex(std::span<std::filesystem::path const>(paths));
+
+    for (auto i = 0zu; i < paths.size(); ++i) {
+        auto const& file = result.files[i];
+        std::cout << paths[i].string() << ": " << (file.ok ? "" : "unreadable, ") << file.tokens.size() << " tokens\n";
+    }
+
+    auto const& stats = result.stats;
+    std::cout << stats.files << " files, " << stats.bytes << " bytes, " << stats.tokens << " tokens in "
+        << std::chrono::duration<double, std::milli>(stats.elapsed).count() << "ms ("
+        << stats.tasks << " tasks, " << stats.chunks << " chunks, " << stats.steals << " steals)\n";
+
+    return 0;
+}
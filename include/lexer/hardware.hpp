@@ -0,0 +1,14 @@
+#ifndef DARK_LEXER_HARDWARE_HPP
+#define DARK_LEXER_HARDWARE_HPP
+
+#include <cstddef>
+
+namespace dark::detail {
+
+    // `std::hardware_destructive_interference_size` is ABI-unstable, so we
+    // pin the common value instead.
+    inline constexpr std::size_t cache_line_size = 64;
+
+} // namespace dark::detail
+
+#endif // DARK_LEXER_HARDWARE_HPP
@@ -1,11 +1,16 @@
 #ifndef DARK_LEXER_LEXER_HPP
 #define DARK_LEXER_LEXER_HPP
 
+#include "lexer/simd.hpp"
+#include "lexer/structural.hpp"
 #include "lexer/switch.hpp"
+#include <algorithm>
 #include <concepts>
+#include <ranges>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 namespace dark {
 
     enum class DefaultTokenKind {
@@ -58,6 +63,17 @@ namespace dark {
         Eof
     };
 
+    // Selected through `static constexpr auto engine = ...;` in a config.
+    //
+    // `StructuralIndex` classifies the whole source into per-byte bitmasks
+    // before lexing and produces exactly the tokens of `Sequential`. It
+    // requires `is_valid_identifier` to only look at its first byte, which
+    // is checked at compile time.
+    enum class LexerEngine {
+        Sequential,
+        StructuralIndex
+    };
+
     struct DefaultLexerConfig {
         using kind_t = DefaultTokenKind;
 
@@ -155,6 +171,114 @@ namespace dark {
             { T::parse_number(std::declval<std::string_view>()) } -> std::same_as<std::string_view>;
         };
 
+        // Outside a sequence only the `text_triggers` bytes start a token:
+        // runs of any other bytes are skipped with a vectorized search and
+        // emitted as one `Text` token. A trigger opens a sequence, which is
+        // lexed normally until a token of one of the `sequence_terminators`
+        // kinds (or an `Unknown` one) closes it again.
+        template <typename T>
+        concept has_text_passthrough = requires {
+            { T::text_triggers } -> std::convertible_to<std::string_view>;
+            { *std::ranges::begin(T::sequence_terminators) } -> std::convertible_to<typename T::kind_t>;
+            T::kind_t::Text;
+        };
+
+        // Catches configs that opt into text passthrough but miss part of it;
+        // they would otherwise lex every byte as its own `Unknown` token.
+        template <typename T>
+        concept declares_text_triggers = requires {
+            T::text_triggers;
+        };
+
+        template <typename T>
+        concept uses_structural_index = requires {
+            requires T::engine == LexerEngine::StructuralIndex;
+        };
+
+        template <typename Config>
+            requires has_text_passthrough<Config>
+        inline constexpr auto text_triggers_v = simd::ByteSet<std::string_view(Config::text_triggers).size()>(Config::text_triggers);
+
+        // Whether the lexer is outside a sequence after emitting `kind`.
+        template <typename Config>
+            requires has_text_passthrough<Config>
+        constexpr auto closes_sequence(typename Config::kind_t kind) noexcept -> bool {
+            using kind_t = typename Config::kind_t;
+            if (kind == kind_t::Text || kind == kind_t::Unknown) return true;
+            return std::ranges::find(Config::sequence_terminators, kind) != std::ranges::end(Config::sequence_terminators);
+        }
+
+        template <typename Config>
+        inline constexpr auto byte_classes_v = [] {
+            ByteClassTable classes{};
+            for (auto i = 0zu; i < classes.size(); ++i) {
+                auto const c = static_cast<char>(i);
+                auto const s = std::string_view(&c, 1);
+                auto cls = std::uint8_t{0};
+                if constexpr (has_identifier<Config>) {
+                    if (Config::is_valid_identifier(s)) cls |= IdentifierByte;
+                }
+                if constexpr (has_text_passthrough<Config>) {
+                    if (!text_triggers_v<Config>.contains(c)) cls |= TextByte;
+                }
+                if constexpr (has_whitespace<Config>) {
+                    if (Config::whitespace.can_start(c)) cls |= SwitchStartByte;
+                }
+                if constexpr (has_punctuations<Config>) {
+                    if (Config::punctuations.can_start(c)) cls |= SwitchStartByte;
+                }
+                if constexpr (has_operators<Config>) {
+                    if (Config::operators.can_start(c)) cls |= SwitchStartByte;
+                }
+                classes[i] = cls;
+            }
+            return classes;
+        }();
+
+        template <typename Config>
+        inline constexpr auto byte_classifier_v = ByteClassifier(byte_classes_v<Config>);
+
+        // Identifier runs are measured with one class bit per byte, which is
+        // only exact if `is_valid_identifier` ignores everything past the
+        // first byte. Probed with every two-byte string.
+        template <typename Config>
+        inline constexpr auto has_bytewise_identifiers_v = [] {
+            if constexpr (has_identifier<Config>) {
+                for (auto i = 0zu; i < 256; ++i) {
+                    auto const expected = (byte_classes_v<Config>[i] & IdentifierByte) != 0;
+                    char buffer[2] = { static_cast<char>(i), '\0' };
+                    for (auto j = 0zu; j < 256; ++j) {
+                        buffer[1] = static_cast<char>(j);
+                        if (Config::is_valid_identifier(std::string_view(buffer, 2)) != expected) return false;
+                    }
+                }
+            }
+            return true;
+        }();
+
+        // Stand-in for `StructuralIndex` used by the sequential engine: runs
+        // are measured directly with the config predicates.
+        template <typename Config>
+        struct SequentialIndex {
+            std::string_view source;
+
+            auto identifier_end(std::size_t pos) const noexcept -> std::size_t {
+                auto end = pos;
+                while ((end < source.size()) && (Config::is_valid_identifier(source.substr(end)))) {
+                    ++end;
+                }
+                return end;
+            }
+
+            auto text_end(std::size_t pos) const noexcept -> std::size_t {
+                return pos + 1zu + simd::find_first_of(text_triggers_v<Config>, source.substr(pos + 1));
+            }
+
+            constexpr auto may_start_switch(std::size_t) const noexcept -> bool { return true; }
+
+            constexpr auto token_estimate() const noexcept -> std::size_t { return 0; }
+        };
+
     } // namespace detail
 
     static_assert(detail::LexerConfig<DefaultLexerConfig>, "Lexer config not satisfied");
@@ -171,6 +295,9 @@ namespace dark {
 
     template <detail::LexerConfig Config = DefaultLexerConfig>
     struct Lexer {
+        static_assert(!detail::declares_text_triggers<Config> || detail::has_text_passthrough<Config>,
+            "Text passthrough requires `text_triggers`, `sequence_terminators` and a `kind_t::Text` token kind");
+
         constexpr Lexer(std::string_view source) noexcept
             : m_source(source)
         {}
@@ -182,32 +309,97 @@ namespace dark {
     
 
         auto lex() -> std::vector<Token<typename Config::kind_t>> {
+            if constexpr (detail::uses_structural_index<Config>) {
+                static_assert(detail::has_bytewise_identifiers_v<Config>, "LexerEngine::StructuralIndex requires `is_valid_identifier` to depend on the first byte only");
+                return lex_with(detail::StructuralIndex(m_source, detail::byte_classifier_v<Config>));
+            } else {
+                return lex_with(detail::SequentialIndex<Config>{m_source});
+            }
+        }
+
+        // Produces a single token and advances the cursor past it. Once the
+        // source is exhausted every call returns an `Eof` token, so `lex()` and
+        // incremental consumers (see `PipelinedLexer`) yield identical streams.
+        auto next() -> Token<typename Config::kind_t> {
+            return next_with(detail::SequentialIndex<Config>{m_source});
+        }
+
+        // Resumes lexing at `pos` with the given line state, as if everything
+        // before it had already been lexed. Used to lex chunks of one source
+        // independently (see `ParallelLexer`).
+        constexpr auto seek(unsigned pos, unsigned line, unsigned line_start_pos, bool in_sequence = false) noexcept -> void {
+            m_cursor = pos;
+            m_line = line;
+            m_line_start_pos = line_start_pos;
+            m_in_sequence = in_sequence;
+        }
+
+        constexpr auto cursor() const noexcept -> unsigned { return m_cursor; }
+        constexpr auto line() const noexcept -> unsigned { return m_line; }
+        constexpr auto line_start_pos() const noexcept -> unsigned { return m_line_start_pos; }
+        // Whether a text passthrough config is inside a trigger sequence.
+        constexpr auto in_sequence() const noexcept -> bool { return m_in_sequence; }
+
+    private:
+        template <typename Index>
+        auto lex_with(Index const& index) -> std::vector<Token<typename Config::kind_t>> {
             using kind_t = typename Config::kind_t;
             std::vector<Token<kind_t>> tokens{};
-            auto line = 0u;
-            auto line_start_pos = 0u;
-
-            while (m_cursor < m_source.size()) {
-                auto source = m_source.substr(m_cursor);
-                if (source[0] == '\n') {
-                    ++line;
-                    line_start_pos = m_cursor;
-                }    
+            tokens.reserve(index.token_estimate() + 1);
+
+            while (true) {
+                auto token = next_with(index);
+                tokens.push_back(token);
+                if (token.kind == kind_t::Eof) break;
+            }
+
+            return tokens;
+        }
+
+        // `Index` answers where identifier and text runs end and whether a
+        // Switch can match at a position; everything else is shared so both
+        // engines agree token for token.
+        template <typename Index>
+        auto next_with(Index const& index) -> Token<typename Config::kind_t> {
+            using kind_t = typename Config::kind_t;
+
+            if (m_cursor >= m_source.size()) {
+                return make_token(kind_t::Eof, "");
+            }
+
+            auto source = m_source.substr(m_cursor);
+            if (source[0] == '\n') {
+                ++m_line;
+                m_line_start_pos = m_cursor;
+            }
+            if constexpr (detail::has_text_passthrough<Config>) {
+                if (!m_in_sequence) {
+                    if (!detail::text_triggers_v<Config>.contains(source[0])) {
+                        auto end = index.text_end(m_cursor) - m_cursor;
+                        return make_text_token(source.substr(0, end));
+                    }
+                    m_in_sequence = true;
+                }
+
+                auto token = lex_token(index, source);
+                m_in_sequence = !detail::closes_sequence<Config>(token.kind);
+                return token;
+            } else {
+                return lex_token(index, source);
+            }
+        }
+
+        template <typename Index>
+        auto lex_token(Index const& index, std::string_view source) -> Token<typename Config::kind_t> {
+            using kind_t = typename Config::kind_t;
+
+            if (index.may_start_switch(m_cursor)) {
                 if constexpr (detail::has_whitespace<Config>) {
                     auto id = Config::whitespace.match(source);
                     if (id != Config::whitespace.npos) {
                         auto text = Config::whitespace.str_from_index(id);
                         auto kind = Config::whitespace.token_from_index(id);
-                        auto size = static_cast<unsigned>(text.size());
-                        tokens.push_back({
-                            .kind = kind,
-                            .text = text,
-                            .start = m_cursor,
-                            .line = line,
-                            .col = m_cursor - line_start_pos
-                        });
-                        m_cursor += size;
-                        continue;
+                        return make_token(kind, text);
                     }
                 }
                 if constexpr (detail::has_punctuations<Config>) {
@@ -215,96 +407,62 @@ namespace dark {
                     if (id != Config::punctuations.npos) {
                         auto text = Config::punctuations.str_from_index(id);
                         auto kind = Config::punctuations.token_from_index(id);
-                        auto size = static_cast<unsigned>(text.size());
-                        tokens.push_back({
-                            .kind = kind,
-                            .text = text,
-                            .start = m_cursor,
-                            .line = line,
-                            .col = m_cursor - line_start_pos
-                        });
-                        m_cursor += size;
-                        continue;
+                        return make_token(kind, text);
                     }
                 }
-               if constexpr (detail::has_operators<Config>) {
+                if constexpr (detail::has_operators<Config>) {
                     auto id = Config::operators.match(source);
                     if (id != Config::operators.npos) {
                         auto text = Config::operators.str_from_index(id);
                         auto kind = Config::operators.token_from_index(id);
-                        auto size = static_cast<unsigned>(text.size());
-                        tokens.push_back({
-                            .kind = kind,
-                            .text = text,
-                            .start = m_cursor,
-                            .line = line,
-                            .col = m_cursor - line_start_pos
-                        });
-                        m_cursor += size;
-                        continue;
+                        return make_token(kind, text);
                     }
                 }
-                if constexpr (detail::has_identifier<Config>) {
-                    if (Config::is_valid_identifier_start(source)) {
-                        auto end = 0zu;
-                        while ((end < source.size()) && (Config::is_valid_identifier(source.substr(end)))) {
-                            ++end;
-                        }
-
-                        auto text = source.substr(0, end);
-                        tokens.push_back({
-                            .kind = kind_t::Identifier,
-                            .text = text,
-                            .start = m_cursor,
-                            .line = line,
-                            .col = m_cursor - line_start_pos
-                        });
-
-                        m_cursor += static_cast<unsigned>(end);
-                        continue;
-                    }
+            }
+            if constexpr (detail::has_identifier<Config>) {
+                if (Config::is_valid_identifier_start(source)) {
+                    auto end = index.identifier_end(m_cursor) - m_cursor;
+                    return make_token(kind_t::Identifier, source.substr(0, end));
                 }
-                if constexpr (detail::has_numbers<Config>) {
-                    if (Config::is_digit(source)) {
-                        auto text = Config::parse_number(source);
-                        
-                        tokens.push_back({
-                            .kind = kind_t::Number,
-                            .text = text,
-                            .start = m_cursor,
-                            .line = line,
-                            .col = m_cursor - line_start_pos
-                        });
-
-                        m_cursor += static_cast<unsigned>(text.size());
-                        continue;
-                    } 
+            }
+            if constexpr (detail::has_numbers<Config>) {
+                if (Config::is_digit(source)) {
+                    return make_token(kind_t::Number, Config::parse_number(source));
                 }
-                
-                tokens.push_back({
-                    .kind = kind_t::Unknown,
-                    .text = source.substr(0, 1),
-                    .start = m_cursor,
-                    .line = line,
-                    .col = m_cursor - line_start_pos
-                });
-                m_cursor += 1u;
-                
             }
 
-            tokens.push_back({
-                .kind = kind_t::Eof,
-                .text = "",
-                .start = m_cursor,
-                .line = line,
-                .col = m_cursor - line_start_pos
-            });
+            return make_token(kind_t::Unknown, source.substr(0, 1));
+        }
 
-            return tokens;
+        // Text spans may cover several lines, so the line bookkeeping that
+        // `next()` does for a leading '\n' is repeated for the rest of the span.
+        auto make_text_token(std::string_view text) noexcept -> Token<typename Config::kind_t> {
+            auto token = make_token(Config::kind_t::Text, text);
+            auto const newlines = detail::simd::count_byte('\n', text.substr(1));
+            if (newlines.count != 0) {
+                m_line += static_cast<unsigned>(newlines.count);
+                m_line_start_pos = token.start + 1u + static_cast<unsigned>(newlines.last);
+            }
+            return token;
+        }
+
+        constexpr auto make_token(typename Config::kind_t kind, std::string_view text) noexcept -> Token<typename Config::kind_t> {
+            auto token = Token<typename Config::kind_t>{
+                .kind = kind,
+                .text = text,
+                .start = m_cursor,
+                .line = m_line,
+                .col = m_cursor - m_line_start_pos
+            };
+            m_cursor += static_cast<unsigned>(text.size());
+            return token;
         }
 
     private:
         unsigned m_cursor{0};
+        unsigned m_line{0};
+        unsigned m_line_start_pos{0};
+        bool m_in_sequence{false};
         std::string_view m_source;
     };
 
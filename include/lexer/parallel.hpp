@@ -0,0 +1,337 @@
+#ifndef DARK_LEXER_PARALLEL_HPP
+#define DARK_LEXER_PARALLEL_HPP
+
+#include "lexer/lexer.hpp"
+#include "lexer/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dark {
+
+    struct ParallelLexOptions {
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        // Files larger than this are cut into chunks of about this size.
+        std::size_t chunk_size = 1zu << 20;
+        // Files smaller than this are grouped until a task covers this much.
+        std::size_t batch_size = 64zu << 10;
+    };
+
+    struct ParallelLexStats {
+        std::size_t files{0};
+        std::size_t bytes{0};
+        std::size_t tokens{0};
+        std::size_t tasks{0};
+        std::size_t split_files{0};
+        std::size_t chunks{0};
+        std::size_t steals{0};
+        std::size_t unreadable_files{0};
+        std::chrono::nanoseconds elapsed{0};
+    };
+
+    template <typename Kind>
+    struct FileTokens {
+        std::string_view source;
+        std::vector<Token<Kind>> tokens;
+        // False when the file could not be read; `tokens` is then empty.
+        bool ok{true};
+    };
+
+    template <typename Kind>
+    struct ParallelLexResult {
+        // Owns the file contents when lexing from paths; `files[i].source`
+        // and the token texts point into it.
+        std::vector<std::string> storage;
+        std::vector<FileTokens<Kind>> files;
+        ParallelLexStats stats;
+    };
+
+    // Lexes many sources with `Lexer<Config>` on a work-stealing pool. Every
+    // file yields exactly the tokens `Lexer<Config>(source).lex()` would.
+    //
+    // Small files are batched so per-task overhead stays negligible. With
+    // more than one thread, large files are cut at newlines and their chunks
+    // lexed concurrently; each chunk is later stitched onto the previous one
+    // at the first token both agree on, re-lexing only when a token crossed
+    // the cut.
+    //
+    // The worker threads live as long as the lexer, so one instance should
+    // be reused across calls; `lex` must not be called concurrently.
+    template <detail::LexerConfig Config = DefaultLexerConfig>
+    class ParallelLexer {
+    public:
+        using kind_t = typename Config::kind_t;
+        using token_t = Token<kind_t>;
+        using result_t = ParallelLexResult<kind_t>;
+
+        explicit ParallelLexer(ParallelLexOptions options = {})
+            : m_options(options)
+            , m_pool(options.threads)
+        {}
+
+        auto lex(std::span<std::string_view const> sources) -> result_t {
+            auto const start = std::chrono::steady_clock::now();
+            auto result = result_t{};
+            result.files.resize(sources.size());
+            for (auto i = 0zu; i < sources.size(); ++i) {
+                result.files[i].source = sources[i];
+            }
+
+            lex_files(result);
+            result.stats.elapsed = std::chrono::steady_clock::now() - start;
+            return result;
+        }
+
+        auto lex(std::span<std::filesystem::path const> paths) -> result_t {
+            auto const start = std::chrono::steady_clock::now();
+            auto result = result_t{};
+            result.storage.resize(paths.size());
+            result.files.resize(paths.size());
+
+            auto tasks = std::vector<std::function<void()>>{};
+            tasks.reserve(paths.size());
+            for (auto i = 0zu; i < paths.size(); ++i) {
+                tasks.emplace_back([&result, &paths, i] {
+                    result.files[i].ok = read_file(paths[i], result.storage[i]);
+                    result.files[i].source = result.storage[i];
+                });
+            }
+            result.stats.steals += m_pool.run(tasks);
+
+            lex_files(result);
+            result.stats.elapsed = std::chrono::steady_clock::now() - start;
+            return result;
+        }
+
+    private:
+        struct Chunk {
+            std::size_t file;
+            unsigned begin;
+            unsigned end;
+            bool is_last;
+            std::vector<token_t> tokens{};
+            unsigned end_cursor{0};
+            unsigned end_line{0};
+            unsigned end_line_start{0};
+            bool end_in_sequence{false};
+            // Filled in by `stitch`: `tokens[skip..]` land at `offset` in the
+            // file's output with their line shifted by `line_delta`.
+            std::size_t skip{0};
+            std::size_t offset{0};
+            unsigned line_delta{0};
+        };
+
+        struct Task {
+            std::size_t cost;
+            std::vector<std::size_t> files{};
+            std::size_t chunk{0};
+            bool is_chunk{false};
+        };
+
+        auto lex_files(result_t& result) -> void {
+            auto& files = result.files;
+            auto& stats = result.stats;
+
+            auto chunks = std::vector<Chunk>{};
+            auto tasks = std::vector<Task>{};
+            auto batch = Task{.cost = 0};
+            // First chunk and chunk count of every file lexed in chunks.
+            auto split_files = std::vector<std::pair<std::size_t, std::size_t>>{};
+
+            for (auto i = 0zu; i < files.size(); ++i) {
+                auto const source = files[i].source;
+                stats.bytes += source.size();
+                if (!files[i].ok) ++stats.unreadable_files;
+
+                if (m_pool.thread_count() > 1 && source.size() > m_options.chunk_size + m_options.chunk_size / 2) {
+                    auto const first = chunks.size();
+                    split(i, source, chunks);
+                    split_files.emplace_back(first, chunks.size() - first);
+                    if (chunks.size() - first > 1) ++stats.split_files;
+                    for (auto c = first; c < chunks.size(); ++c) {
+                        tasks.push_back({ .cost = chunks[c].end - chunks[c].begin, .chunk = c, .is_chunk = true });
+                    }
+                    continue;
+                }
+
+                batch.cost += source.size();
+                batch.files.push_back(i);
+                if (batch.cost >= m_options.batch_size) {
+                    tasks.push_back(std::move(batch));
+                    batch = Task{.cost = 0};
+                }
+            }
+            if (!batch.files.empty()) tasks.push_back(std::move(batch));
+
+            std::stable_sort(tasks.begin(), tasks.end(), [](Task const& l, Task const& r) { return l.cost > r.cost; });
+
+            auto jobs = std::vector<std::function<void()>>{};
+            jobs.reserve(tasks.size());
+            for (auto const& task : tasks) {
+                if (task.is_chunk) {
+                    jobs.emplace_back([&chunks, &files, c = task.chunk] { lex_chunk(files[chunks[c].file].source, chunks[c]); });
+                } else {
+                    jobs.emplace_back([&files, ids = std::span(task.files)] {
+                        for (auto id : ids) {
+                            if (files[id].ok) files[id].tokens = Lexer<Config>(files[id].source).lex();
+                        }
+                    });
+                }
+            }
+            stats.steals += m_pool.run(jobs);
+
+            // Stitch every chunked file; files are independent so this runs on
+            // the pool as well. It only sizes the output and records where
+            // each chunk goes, the tokens are then placed chunk by chunk.
+            jobs.clear();
+            for (auto [first, count] : split_files) {
+                jobs.emplace_back([&chunks, &files, first, count] {
+                    stitch(files[chunks[first].file], std::span(chunks).subspan(first, count));
+                });
+            }
+            stats.steals += m_pool.run(jobs);
+
+            jobs.clear();
+            for (auto c = 0zu; c < chunks.size(); ++c) {
+                jobs.emplace_back([&chunks, &files, c] { place(files[chunks[c].file].tokens, chunks[c]); });
+            }
+            stats.steals += m_pool.run(jobs);
+
+            stats.files = files.size();
+            stats.tasks = tasks.size();
+            stats.chunks = chunks.size();
+            stats.tokens = std::accumulate(files.begin(), files.end(), 0zu, [](auto acc, auto const& f) { return acc + f.tokens.size(); });
+        }
+
+        // Cuts right before a '\n' so every chunk after the first opens with a
+        // newline, which resets the column base the chunk lexer tracks.
+        auto split(std::size_t file, std::string_view source, std::vector<Chunk>& chunks) const -> void {
+            auto begin = 0zu;
+            while (true) {
+                auto cut = source.size();
+                if (source.size() - begin > m_options.chunk_size + m_options.chunk_size / 2) {
+                    cut = source.find('\n', begin + m_options.chunk_size);
+                    if (cut == std::string_view::npos) cut = source.size();
+                }
+                chunks.push_back({
+                    .file = file,
+                    .begin = static_cast<unsigned>(begin),
+                    .end = static_cast<unsigned>(cut),
+                    .is_last = cut == source.size()
+                });
+                if (cut == source.size()) return;
+                begin = cut;
+            }
+        }
+
+        static auto lex_chunk(std::string_view source, Chunk& chunk) -> void {
+            auto lexer = Lexer<Config>(source);
+            lexer.seek(chunk.begin, 0, chunk.begin);
+            while (lexer.cursor() < chunk.end) {
+                chunk.tokens.push_back(lexer.next());
+            }
+            if (chunk.is_last) chunk.tokens.push_back(lexer.next());
+
+            chunk.end_cursor = lexer.cursor();
+            chunk.end_line = lexer.line();
+            chunk.end_line_start = lexer.line_start_pos();
+            chunk.end_in_sequence = lexer.in_sequence();
+        }
+
+        // Chunks are lexed from outside any text passthrough sequence; a
+        // token is only reusable if the chunk lexer reached it in the state
+        // the stitched stream is in.
+        static auto in_sequence_before(Chunk const& chunk, typename std::vector<token_t>::const_iterator it) noexcept -> bool {
+            if constexpr (detail::has_text_passthrough<Config>) {
+                return it != chunk.tokens.begin() && !detail::closes_sequence<Config>(std::prev(it)->kind);
+            } else {
+                return false;
+            }
+        }
+
+        // Chunk `k` was lexed with line numbers relative to its start and may
+        // begin inside a token the previous chunk ran past. Its tokens are
+        // reused from the first one that starts exactly where the stitched
+        // stream stopped and sees the same line state; otherwise the chunk is
+        // re-lexed sequentially from there.
+        static auto stitch(FileTokens<kind_t>& file, std::span<Chunk> chunks) -> void {
+            auto const source = file.source;
+
+            auto cursor = 0u;
+            auto line = 0u;
+            auto line_start = 0u;
+            auto in_sequence = false;
+            auto total = 0zu;
+            for (auto& chunk : chunks) {
+                auto it = std::ranges::lower_bound(std::as_const(chunk.tokens), cursor, {}, &token_t::start);
+                auto synced = it != chunk.tokens.end() && it->start == cursor && in_sequence_before(chunk, it) == in_sequence;
+                auto leading_newline = false;
+                if (synced) {
+                    leading_newline = it->start < source.size() && source[it->start] == '\n';
+                    synced = leading_newline || it->start - it->col == line_start;
+                }
+
+                if (synced) {
+                    chunk.skip = static_cast<std::size_t>(it - chunk.tokens.cbegin());
+                    chunk.line_delta = line - (it->line - static_cast<unsigned>(leading_newline));
+                    cursor = chunk.end_cursor;
+                    line = chunk.end_line + chunk.line_delta;
+                    line_start = chunk.end_line_start;
+                    in_sequence = chunk.end_in_sequence;
+                } else {
+                    auto lexer = Lexer<Config>(source);
+                    lexer.seek(cursor, line, line_start, in_sequence);
+                    chunk.tokens.clear();
+                    while (lexer.cursor() < chunk.end) {
+                        chunk.tokens.push_back(lexer.next());
+                    }
+                    if (chunk.is_last) chunk.tokens.push_back(lexer.next());
+                    chunk.skip = 0;
+                    chunk.line_delta = 0;
+                    cursor = lexer.cursor();
+                    line = lexer.line();
+                    line_start = lexer.line_start_pos();
+                    in_sequence = lexer.in_sequence();
+                }
+
+                chunk.offset = total;
+                total += chunk.tokens.size() - chunk.skip;
+            }
+            file.tokens.resize(total);
+        }
+
+        static auto place(std::vector<token_t>& out, Chunk& chunk) -> void {
+            auto const first = chunk.tokens.begin() + static_cast<std::ptrdiff_t>(chunk.skip);
+            std::transform(first, chunk.tokens.end(), out.begin() + static_cast<std::ptrdiff_t>(chunk.offset), [delta = chunk.line_delta](token_t token) {
+                token.line += delta;
+                return token;
+            });
+            chunk.tokens = {};
+        }
+
+        static auto read_file(std::filesystem::path const& path, std::string& out) -> bool {
+            auto file = std::ifstream(path, std::ios::binary);
+            if (!file) return false;
+            out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            return !file.bad();
+        }
+
+    private:
+        ParallelLexOptions m_options;
+        detail::WorkStealingPool m_pool;
+    };
+
+} // namespace dark
+
+#endif // DARK_LEXER_PARALLEL_HPP
@@ -0,0 +1,152 @@
+#ifndef DARK_LEXER_PIPELINE_HPP
+#define DARK_LEXER_PIPELINE_HPP
+
+#include "lexer/lexer.hpp"
+#include "lexer/spsc_ring.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <thread>
+
+namespace dark {
+
+    template <typename Kind, std::size_t N>
+        requires (N > 0)
+    struct TokenBatch {
+        std::array<Token<Kind>, N> tokens;
+        std::size_t size{0};
+        bool is_last{false};
+
+        constexpr auto begin() const noexcept { return tokens.begin(); }
+        constexpr auto end() const noexcept { return tokens.begin() + static_cast<std::ptrdiff_t>(size); }
+    };
+
+    // Runs `Lexer<Config>` on a producer thread and publishes fixed-size
+    // token batches through a lock-free SPSC ring. The producer blocks when
+    // `RingSize` batches are in flight, so memory stays bounded no matter how
+    // far ahead of the consumer the lexer gets.
+    //
+    // The consumer either walks batches (`pop_batch`/`try_pop_batch` followed
+    // by `release_batch`) or iterates tokens with a blocking range-for. The
+    // token stream, including the trailing `Eof`, is identical to `lex()`.
+    template <detail::LexerConfig Config = DefaultLexerConfig, std::size_t BatchSize = 256, std::size_t RingSize = 16>
+    class PipelinedLexer {
+    public:
+        using kind_t = typename Config::kind_t;
+        using token_t = Token<kind_t>;
+        using batch_t = TokenBatch<kind_t, BatchSize>;
+
+        PipelinedLexer(std::string_view source)
+            : m_producer([this, source] { produce(source); })
+        {}
+        PipelinedLexer(PipelinedLexer const&) = delete;
+        PipelinedLexer& operator=(PipelinedLexer const&) = delete;
+        PipelinedLexer(PipelinedLexer &&) = delete;
+        PipelinedLexer& operator=(PipelinedLexer &&) = delete;
+
+        ~PipelinedLexer() noexcept {
+            m_stop.store(true);
+            m_ring.clear();
+            m_producer.join();
+        }
+
+        // Blocks until the next batch is published. Returns `nullptr` after
+        // the batch holding `Eof` has been released.
+        auto pop_batch() noexcept -> batch_t const* {
+            if (m_finished) return nullptr;
+            return m_ring.front();
+        }
+
+        // Polling variant of `pop_batch`; also returns `nullptr` when the
+        // producer has not published anything yet.
+        auto try_pop_batch() noexcept -> batch_t const* {
+            if (m_finished) return nullptr;
+            return m_ring.try_front();
+        }
+
+        // Hands the batch returned by `pop_batch`/`try_pop_batch` back to the
+        // producer. The batch must not be accessed afterwards.
+        auto release_batch(batch_t const* batch) noexcept -> void {
+            m_finished = batch->is_last;
+            m_ring.pop();
+        }
+
+        auto is_finished() const noexcept -> bool { return m_finished; }
+
+        struct sentinel {};
+
+        class iterator {
+        public:
+            using value_type = token_t;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() noexcept = default;
+            explicit iterator(PipelinedLexer* lexer) noexcept
+                : m_lexer(lexer)
+                , m_batch(lexer->pop_batch())
+            {}
+
+            auto operator*() const noexcept -> token_t const& { return m_batch->tokens[m_index]; }
+            auto operator->() const noexcept -> token_t const* { return &m_batch->tokens[m_index]; }
+
+            auto operator++() noexcept -> iterator& {
+                if (++m_index == m_batch->size) {
+                    m_lexer->release_batch(m_batch);
+                    m_batch = m_lexer->pop_batch();
+                    m_index = 0;
+                }
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> void { ++*this; }
+
+            friend auto operator==(iterator const& it, sentinel) noexcept -> bool { return it.m_batch == nullptr; }
+
+        private:
+            PipelinedLexer* m_lexer{nullptr};
+            batch_t const* m_batch{nullptr};
+            std::size_t m_index{0};
+        };
+
+        // Single-pass: tokens are consumed as the iterator advances.
+        auto begin() noexcept -> iterator { return iterator(this); }
+        auto end() const noexcept -> sentinel { return {}; }
+
+    private:
+        auto produce(std::string_view source) noexcept -> void {
+            auto lexer = Lexer<Config>(source);
+            auto done = false;
+
+            while (!done && !m_stop.load(std::memory_order_acquire)) {
+                auto batch = m_ring.back(m_stop);
+                if (batch == nullptr) return;
+
+                batch->size = 0;
+                while (batch->size < BatchSize) {
+                    auto token = lexer.next();
+                    batch->tokens[batch->size++] = token;
+                    if (token.kind == kind_t::Eof) {
+                        done = true;
+                        break;
+                    }
+                }
+                batch->is_last = done;
+                m_ring.push();
+            }
+        }
+
+    private:
+        detail::SpscRing<batch_t, RingSize> m_ring{};
+        std::atomic<bool> m_stop{false};
+        bool m_finished{false};
+        std::thread m_producer;
+    };
+
+    static_assert(std::input_iterator<PipelinedLexer<>::iterator>);
+    static_assert(std::sentinel_for<PipelinedLexer<>::sentinel, PipelinedLexer<>::iterator>);
+
+} // namespace dark
+
+#endif // DARK_LEXER_PIPELINE_HPP
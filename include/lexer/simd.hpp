@@ -0,0 +1,163 @@
+#ifndef DARK_LEXER_SIMD_HPP
+#define DARK_LEXER_SIMD_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSSE3__)
+    #include <tmmintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace dark::detail::simd {
+
+    // A byte set split into two 16-entry tables so that byte `b` is a member
+    // iff `low[b & 15] & high[b >> 4]` is non-zero. Every distinct row (the
+    // low nibbles present under one high nibble) gets one bit, so the split
+    // is exact while the set has at most eight distinct non-empty rows. With
+    // `pshufb` a membership test is then two shuffles per 16 bytes.
+    struct NibbleTable {
+        alignas(16) std::array<std::uint8_t, 16> low{};
+        alignas(16) std::array<std::uint8_t, 16> high{};
+        bool exact{true};
+
+        constexpr NibbleTable() noexcept = default;
+
+        constexpr explicit NibbleTable(std::array<bool, 256> const& members) noexcept {
+            std::array<std::uint16_t, 8> rows{};
+            auto row_count = 0zu;
+            for (auto h = 0zu; h < 16; ++h) {
+                auto row = std::uint16_t{0};
+                for (auto l = 0zu; l < 16; ++l) {
+                    if (members[h * 16 + l]) row = static_cast<std::uint16_t>(row | (1u << l));
+                }
+                if (row == 0) continue;
+
+                auto id = 0zu;
+                while (id < row_count && rows[id] != row) ++id;
+                if (id == row_count) {
+                    if (row_count == rows.size()) {
+                        exact = false;
+                        return;
+                    }
+                    rows[row_count++] = row;
+                    for (auto l = 0zu; l < 16; ++l) {
+                        if ((row >> l) & 1) low[l] = static_cast<std::uint8_t>(low[l] | (1u << id));
+                    }
+                }
+                high[h] = static_cast<std::uint8_t>(1u << id);
+            }
+        }
+    };
+
+#if defined(__SSSE3__)
+    // Membership mask of 16 bytes whose nibbles were already split out.
+    inline auto match_nibbles(NibbleTable const& table, __m128i low_nibbles, __m128i high_nibbles) noexcept -> unsigned {
+        auto const low = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<__m128i const*>(table.low.data())), low_nibbles);
+        auto const high = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<__m128i const*>(table.high.data())), high_nibbles);
+        auto const misses = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+        return ~static_cast<unsigned>(_mm_movemask_epi8(misses)) & 0xffffu;
+    }
+#endif
+
+    // Compile-time set of bytes. `table` answers scalar membership queries
+    // for the tail; the vector paths use either `nibbles` or `bytes`.
+    template <std::size_t N>
+    struct ByteSet {
+        std::array<char, N> bytes{};
+        std::array<bool, 256> table{};
+        NibbleTable nibbles{};
+
+        constexpr ByteSet(std::string_view s) noexcept {
+            for (auto i = 0zu; i < N; ++i) {
+                bytes[i] = s[i];
+                table[static_cast<unsigned char>(s[i])] = true;
+            }
+            nibbles = NibbleTable(table);
+        }
+
+        constexpr auto contains(char c) const noexcept -> bool {
+            return table[static_cast<unsigned char>(c)];
+        }
+    };
+
+    // Returns the index of the first byte of `s` in `set`, or `s.size()`.
+    template <std::size_t N>
+    inline auto find_first_of(ByteSet<N> const& set, std::string_view s) noexcept -> std::size_t {
+        if constexpr (N == 0) {
+            return s.size();
+        } else if constexpr (N == 1) {
+            auto const* p = static_cast<char const*>(std::memchr(s.data(), set.bytes[0], s.size()));
+            return p == nullptr ? s.size() : static_cast<std::size_t>(p - s.data());
+        } else {
+            auto i = 0zu;
+#if defined(__SSSE3__)
+            if (set.nibbles.exact) {
+                auto const nibble = _mm_set1_epi8(0x0f);
+                for (; i + 16 <= s.size(); i += 16) {
+                    auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s.data() + i));
+                    auto const mask = match_nibbles(set.nibbles, _mm_and_si128(block, nibble), _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+                    if (mask != 0) return i + static_cast<std::size_t>(std::countr_zero(mask));
+                }
+            }
+#endif
+#if defined(__SSE2__)
+            // One compare per member, so this stays cheap only for the small
+            // trigger sets passthrough configs usually declare.
+            for (; i + 16 <= s.size(); i += 16) {
+                auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s.data() + i));
+                auto hits = _mm_setzero_si128();
+                for (auto b : set.bytes) {
+                    hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(b)));
+                }
+                auto const mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+                if (mask != 0) return i + static_cast<std::size_t>(std::countr_zero(mask));
+            }
+#endif
+            for (; i < s.size(); ++i) {
+                if (set.contains(s[i])) return i;
+            }
+            return s.size();
+        }
+    }
+
+    struct ByteCount {
+        std::size_t count{0};
+        // Index of the last occurrence, or `std::string_view::npos`.
+        std::size_t last{std::string_view::npos};
+    };
+
+    // Counts `c` in `s` and finds its last occurrence in a single forward
+    // pass, 64 bytes at a time.
+    inline auto count_byte(char c, std::string_view s) noexcept -> ByteCount {
+        auto res = ByteCount{};
+        auto i = 0zu;
+#if defined(__SSE2__)
+        auto const needle = _mm_set1_epi8(c);
+        auto const mask_of = [&](std::size_t offset) {
+            auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s.data() + offset));
+            return static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle))));
+        };
+        for (; i + 64 <= s.size(); i += 64) {
+            auto const mask = mask_of(i) | (mask_of(i + 16) << 16) | (mask_of(i + 32) << 32) | (mask_of(i + 48) << 48);
+            if (mask == 0) continue;
+            res.count += static_cast<std::size_t>(std::popcount(mask));
+            res.last = i + 63zu - static_cast<std::size_t>(std::countl_zero(mask));
+        }
+#endif
+        for (; i < s.size(); ++i) {
+            if (s[i] != c) continue;
+            ++res.count;
+            res.last = i;
+        }
+        return res;
+    }
+
+} // namespace dark::detail::simd
+
+#endif // DARK_LEXER_SIMD_HPP
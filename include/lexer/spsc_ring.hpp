@@ -0,0 +1,152 @@
+#ifndef DARK_LEXER_SPSC_RING_HPP
+#define DARK_LEXER_SPSC_RING_HPP
+
+#include "lexer/hardware.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dark::detail {
+
+    // Bounded lock-free single-producer/single-consumer ring.
+    //
+    // Slots are handed out in place: the producer fills `back()` and publishes
+    // it with `push()`, the consumer reads `front()` and recycles it with
+    // `pop()`. Head and tail are monotonically increasing counters, so the
+    // ring is full when `head - tail == Capacity` and no slot is ever wasted.
+    //
+    // Blocking calls first spin on `yield` for `spin_limit` rounds, which
+    // covers the common case of a batch being filled faster than a wake-up
+    // round-trip, and then park on a condition variable. A side that is far
+    // ahead therefore sleeps instead of burning a core the other side needs.
+    template <typename T, std::size_t Capacity>
+        requires (Capacity > 0 && (Capacity & (Capacity - 1)) == 0)
+    class SpscRing {
+        static constexpr std::size_t mask = Capacity - 1;
+        static constexpr unsigned spin_limit = 64;
+
+        // Keeps neighbouring slots, written by different threads, off each
+        // other's cache lines.
+        struct alignas(cache_line_size) Slot {
+            T value{};
+        };
+
+        // The flag lets the other side skip the mutex while nobody sleeps.
+        // It is stored before the sleeper re-checks the ring and loaded after
+        // the other side updated it, both sequentially consistent, so at
+        // least one of them sees the other's write.
+        struct Parking {
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::atomic<bool> waiting{false};
+
+            template <typename Fn>
+            auto wait(Fn ready) -> void {
+                auto lock = std::unique_lock(mutex);
+                waiting.store(true);
+                cv.wait(lock, ready);
+                waiting.store(false, std::memory_order_relaxed);
+            }
+
+            auto notify() -> void {
+                if (!waiting.load()) return;
+                { auto lock = std::lock_guard(mutex); }
+                cv.notify_one();
+            }
+        };
+
+    public:
+        SpscRing()
+            : m_slots(std::make_unique<Slot[]>(Capacity))
+        {}
+        SpscRing(SpscRing const&) = delete;
+        SpscRing& operator=(SpscRing const&) = delete;
+        SpscRing(SpscRing &&) = delete;
+        SpscRing& operator=(SpscRing &&) = delete;
+        ~SpscRing() noexcept = default;
+
+        // Producer side
+
+        auto try_back() noexcept -> T* {
+            auto head = m_head.load(std::memory_order_relaxed);
+            if (head - m_cached_tail == Capacity) {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+                if (head - m_cached_tail == Capacity) return nullptr;
+            }
+            return &m_slots[head & mask].value;
+        }
+
+        // Blocks until a slot is free; returns `nullptr` once `stop` is set.
+        // `stop` must be set before the consumer calls `clear()`.
+        auto back(std::atomic<bool> const& stop) -> T* {
+            for (auto spin = 0u; ; ++spin) {
+                if (auto slot = try_back(); slot != nullptr) return slot;
+                if (stop.load(std::memory_order_acquire)) return nullptr;
+                if (spin < spin_limit) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                auto const head = m_head.load(std::memory_order_relaxed);
+                m_producer.wait([&] { return head - m_tail.load() != Capacity || stop.load(); });
+            }
+        }
+
+        auto push() -> void {
+            m_head.fetch_add(1);
+            m_consumer.notify();
+        }
+
+        // Consumer side
+
+        auto try_front() noexcept -> T* {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_cached_head) {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                if (tail == m_cached_head) return nullptr;
+            }
+            return &m_slots[tail & mask].value;
+        }
+
+        auto front() -> T* {
+            for (auto spin = 0u; ; ++spin) {
+                if (auto slot = try_front(); slot != nullptr) return slot;
+                if (spin < spin_limit) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                auto const tail = m_tail.load(std::memory_order_relaxed);
+                m_consumer.wait([&] { return m_head.load() != tail; });
+            }
+        }
+
+        auto pop() -> void {
+            m_tail.fetch_add(1);
+            m_producer.notify();
+        }
+
+        // Drops every published slot and wakes a producer blocked in `back()`
+        // so it can observe its stop flag. Must only be called from the
+        // consumer side.
+        auto clear() -> void {
+            m_tail.store(m_head.load(std::memory_order_acquire));
+            m_producer.notify();
+        }
+
+    private:
+        alignas(cache_line_size) std::atomic<std::size_t> m_head{0};
+        std::size_t m_cached_tail{0};
+        alignas(cache_line_size) std::atomic<std::size_t> m_tail{0};
+        std::size_t m_cached_head{0};
+        alignas(cache_line_size) Parking m_producer{};
+        alignas(cache_line_size) Parking m_consumer{};
+        // Heap-allocated so a ring of large batches stays cheap to embed in
+        // objects that live on the stack.
+        std::unique_ptr<Slot[]> m_slots;
+    };
+
+} // namespace dark::detail
+
+#endif // DARK_LEXER_SPSC_RING_HPP
@@ -0,0 +1,193 @@
+#ifndef DARK_LEXER_STRUCTURAL_HPP
+#define DARK_LEXER_STRUCTURAL_HPP
+
+#include "lexer/simd.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace dark::detail {
+
+    enum ByteClass : std::uint8_t {
+        IdentifierByte  = 1 << 0,
+        TextByte        = 1 << 1,
+        SwitchStartByte = 1 << 2,
+    };
+
+    using ByteClassTable = std::array<std::uint8_t, 256>;
+
+    // The class table plus, per class, its nibble split for the vectorized
+    // classification. Built once per config at compile time.
+    struct ByteClassifier {
+        ByteClassTable classes;
+        simd::NibbleTable identifier;
+        simd::NibbleTable text;
+        simd::NibbleTable switch_start;
+
+        constexpr explicit ByteClassifier(ByteClassTable const& table) noexcept
+            : classes(table)
+            , identifier(members_of(table, IdentifierByte))
+            , text(members_of(table, TextByte))
+            , switch_start(members_of(table, SwitchStartByte))
+        {}
+
+        constexpr auto is_vectorizable() const noexcept -> bool {
+            return identifier.exact && text.exact && switch_start.exact;
+        }
+
+    private:
+        static constexpr auto members_of(ByteClassTable const& table, ByteClass cls) noexcept -> std::array<bool, 256> {
+            std::array<bool, 256> members{};
+            for (auto i = 0zu; i < members.size(); ++i) {
+                members[i] = (table[i] & cls) != 0;
+            }
+            return members;
+        }
+    };
+
+    // Stage 1 of the two-stage engine: a single pass over the source that
+    // turns every 64-byte block into one bitmask per `ByteClass`. With SSSE3
+    // and classes that split into nibble tables (true for the usual ASCII
+    // ranges) each 16 bytes are classified with two `pshufb` per class;
+    // otherwise every byte is looked up in the class table and the mask bits
+    // are packed eight at a time.
+    //
+    // Stage 2 is still the per-token loop of `Lexer::lex`; the masks only
+    // answer where identifier and text runs end (`countr_zero` instead of
+    // re-testing the config predicates byte by byte) and whether a Switch
+    // can start at a position.
+    class StructuralIndex {
+        struct Block {
+            std::uint64_t identifier;
+            std::uint64_t text;
+            std::uint64_t switch_start;
+        };
+
+    public:
+        StructuralIndex(std::string_view source, ByteClassifier const& classes)
+            : m_blocks(source.size() / 64 + 1, Block{0, 0, 0})
+        {
+            auto const* data = reinterpret_cast<unsigned char const*>(source.data());
+            auto const full_blocks = source.size() / 64;
+
+            auto prev = Block{0, 0, 0};
+            for (auto block = 0zu; block < full_blocks; ++block) {
+                m_blocks[block] = classify(data + block * 64, classes);
+                m_token_estimate += count_starts(m_blocks[block], prev);
+                prev = m_blocks[block];
+            }
+
+            if (auto const tail = source.size() % 64; tail != 0) {
+                unsigned char buffer[64]{};
+                std::copy_n(data + full_blocks * 64, tail, buffer);
+
+                auto const valid = (std::uint64_t{1} << tail) - 1;
+                auto block = classify(buffer, classes);
+                block.identifier &= valid;
+                block.text &= valid;
+                block.switch_start &= valid;
+
+                m_blocks[full_blocks] = block;
+                m_token_estimate += static_cast<std::size_t>(std::popcount(~run_interior(block, prev) & valid));
+            }
+        }
+
+        auto identifier_end(std::size_t pos) const noexcept -> std::size_t {
+            return run_end<&Block::identifier>(pos);
+        }
+
+        auto text_end(std::size_t pos) const noexcept -> std::size_t {
+            return run_end<&Block::text>(pos);
+        }
+
+        auto may_start_switch(std::size_t pos) const noexcept -> bool {
+            return (m_blocks[pos / 64].switch_start >> (pos % 64)) & 1;
+        }
+
+        // Positions that are not inside an identifier or text run. Only
+        // multi-byte Switch lexemes and numbers span several of them, so this
+        // is a close upper bound on the token count, used to size the output.
+        auto token_estimate() const noexcept -> std::size_t { return m_token_estimate; }
+
+    private:
+        static auto classify(unsigned char const* data, ByteClassifier const& classes) noexcept -> Block {
+#if defined(__SSSE3__)
+            if (classes.is_vectorizable()) return classify_nibbles(data, classes);
+#endif
+            return classify_table(data, classes.classes);
+        }
+
+#if defined(__SSSE3__)
+        static auto classify_nibbles(unsigned char const* data, ByteClassifier const& classes) noexcept -> Block {
+            auto block = Block{0, 0, 0};
+            auto const nibble = _mm_set1_epi8(0x0f);
+            for (auto i = 0zu; i < 64; i += 16) {
+                auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+                auto const low = _mm_and_si128(bytes, nibble);
+                auto const high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+                block.identifier   |= std::uint64_t{simd::match_nibbles(classes.identifier, low, high)} << i;
+                block.text         |= std::uint64_t{simd::match_nibbles(classes.text, low, high)} << i;
+                block.switch_start |= std::uint64_t{simd::match_nibbles(classes.switch_start, low, high)} << i;
+            }
+            return block;
+        }
+#endif
+
+        // Gathers eight class bytes into a word, then moves bit `k` of every
+        // byte into one mask byte with a multiply.
+        static auto classify_table(unsigned char const* data, ByteClassTable const& classes) noexcept -> Block {
+            auto block = Block{0, 0, 0};
+            for (auto i = 0zu; i < 64; i += 8) {
+                auto word = std::uint64_t{0};
+                for (auto j = 0zu; j < 8; ++j) {
+                    word |= std::uint64_t{classes[data[i + j]]} << (8 * j);
+                }
+                block.identifier   |= pack_bit(word, 0) << i;
+                block.text         |= pack_bit(word, 1) << i;
+                block.switch_start |= pack_bit(word, 2) << i;
+            }
+            return block;
+        }
+
+        static constexpr auto pack_bit(std::uint64_t word, unsigned bit) noexcept -> std::uint64_t {
+            return (((word >> bit) & 0x0101010101010101ull) * 0x0102040810204080ull) >> 56;
+        }
+
+        // Bytes whose predecessor belongs to the same identifier or text run.
+        static constexpr auto run_interior(Block const& block, Block const& prev) noexcept -> std::uint64_t {
+            auto const identifier = block.identifier & ((block.identifier << 1) | (prev.identifier >> 63));
+            auto const text = block.text & ((block.text << 1) | (prev.text >> 63));
+            return identifier | text;
+        }
+
+        static constexpr auto count_starts(Block const& block, Block const& prev) noexcept -> std::size_t {
+            return static_cast<std::size_t>(std::popcount(~run_interior(block, prev)));
+        }
+
+        // First position at or after `pos` whose bit is clear. Bits past the
+        // end of the source are never set, so the result is bounded by it.
+        template <std::uint64_t Block::* Mask>
+        auto run_end(std::size_t pos) const noexcept -> std::size_t {
+            auto block = pos / 64;
+            auto bits = ~(m_blocks[block].*Mask) >> (pos % 64);
+            if (bits != 0) return pos + static_cast<std::size_t>(std::countr_zero(bits));
+
+            while (true) {
+                ++block;
+                bits = ~(m_blocks[block].*Mask);
+                if (bits != 0) return block * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            }
+        }
+
+    private:
+        std::vector<Block> m_blocks;
+        std::size_t m_token_estimate{0};
+    };
+
+} // namespace dark::detail
+
+#endif // DARK_LEXER_STRUCTURAL_HPP
@@ -4,6 +4,10 @@
 #include "static_string.hpp"
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <numeric>
 #include <type_traits>
 
@@ -74,7 +78,102 @@ namespace dark::detail {
       return temp;
     }();
 
+    static constexpr auto start_chars = [] {
+      std::array<bool, 256> temp{};
+      for (auto const& [el, _] : lexems) {
+        if (!el.empty()) temp[static_cast<unsigned char>(el[0])] = true;
+      }
+      return temp;
+    }();
+
     static constexpr auto max_len = std::max({L0.size(), (Ls.size())...});
+    static constexpr auto min_len = std::min({L0.size(), (Ls.size())...});
+
+    // Short, non-empty lexemes fit in one machine word, so `match_swar` can
+    // do masked compares against the lexemes sharing the first byte instead
+    // of walking `map`.
+    static constexpr bool swar_capable = max_len <= 8 && min_len > 0;
+
+    struct PackedLexem {
+      std::uint64_t value;
+      std::uint64_t mask;
+      std::size_t size;
+      std::size_t index;
+    };
+
+    static constexpr auto pack(std::string_view el, std::size_t index) noexcept -> PackedLexem {
+      auto packed = PackedLexem{ .value = 0, .mask = 0, .size = el.size(), .index = index };
+      for (auto i = 0zu; i < std::min(el.size(), 8zu); ++i) {
+        packed.value |= std::uint64_t{static_cast<unsigned char>(el[i])} << (8 * i);
+        packed.mask |= std::uint64_t{0xff} << (8 * i);
+      }
+      return packed;
+    }
+
+    // Lexemes grouped by first byte. Every group is padded to the size of the
+    // largest one with entries that never match, so the compare loop has a
+    // fixed trip count. Within a group lexemes are sorted by length so the
+    // last hit is the longest match; equal strings keep their order so the
+    // later one wins, as it does in `map`. Group 0 is all padding and serves
+    // bytes no lexeme starts with.
+    static constexpr auto group_of = [] {
+      std::array<std::uint16_t, 256> temp{};
+      auto groups = std::size_t{0};
+      for (auto const& [el, _] : lexems) {
+        if (el.empty()) continue;
+        auto& group = temp[static_cast<unsigned char>(el[0])];
+        if (group == 0) group = static_cast<std::uint16_t>(++groups);
+      }
+      return temp;
+    }();
+
+    static constexpr auto group_count = std::ranges::max(group_of) + 1zu;
+
+    static constexpr auto group_size = [] {
+      std::array<std::size_t, 256> counts{};
+      for (auto const& [el, _] : lexems) {
+        if (!el.empty()) ++counts[static_cast<unsigned char>(el[0])];
+      }
+      return std::ranges::max(counts);
+    }();
+
+    static constexpr auto packed_lexems = [] {
+      constexpr auto padding = PackedLexem{ .value = 1, .mask = 0, .size = 0, .index = std::numeric_limits<std::size_t>::max() };
+
+      std::array<std::array<PackedLexem, group_size>, group_count> temp{};
+      std::array<std::size_t, group_count> used{};
+      for (auto& group : temp) std::ranges::fill(group, padding);
+
+      for (auto k = 0zu; k < lexems.size(); ++k) {
+        if (lexems[k].first.empty()) continue;
+        auto const packed = pack(lexems[k].first, k);
+        auto const g = group_of[static_cast<unsigned char>(lexems[k].first[0])];
+        auto& group = temp[g];
+
+        auto j = used[g]++;
+        for (; j > 0 && group[j - 1].size > packed.size; --j) {
+          group[j] = group[j - 1];
+        }
+        group[j] = packed;
+      }
+      return temp;
+    }();
+
+    // Loads up to 8 bytes with byte `i` of `s` in bits `[8i, 8i + 8)`; bytes
+    // past the end of `s` read as zero. `s` must not be empty.
+    static auto load_word(std::string_view s) noexcept -> std::uint64_t {
+      auto word = std::uint64_t{0};
+      if (s.size() >= 8) [[likely]] {
+        std::memcpy(&word, s.data(), 8);
+      } else {
+        std::memcpy(&word, s.data(), s.size());
+      }
+      if constexpr (std::endian::native == std::endian::big) {
+        word = std::byteswap(word);
+      }
+      return word;
+    }
+
     static constexpr auto max_extent = [] {
       auto sum = std::accumulate(
           index_mapping.begin(), index_mapping.end(), 0zu,
@@ -82,6 +181,23 @@ namespace dark::detail {
       return std::max(0zu, sum) + 1zu;
     }();
 
+    // Entries in `map`, saturating instead of overflowing.
+    static constexpr auto table_size = [] {
+      auto size = 1zu;
+      for (auto i = 0zu; i < max_len; ++i) {
+        if (size > std::numeric_limits<std::size_t>::max() / max_extent) return std::numeric_limits<std::size_t>::max();
+        size *= max_extent;
+      }
+      return size;
+    }();
+
+    // The table lookup is as fast as or faster than `match_swar` whenever
+    // the table can be built; the dependent loads cost more than the walk.
+    // SWAR is only taken when `map` would exceed 2^18 entries, which is
+    // already past GCC's default constexpr loop limit. Two-byte lexemes
+    // (at most 256^2 entries) therefore always use the table.
+    static constexpr bool use_swar = swar_capable && table_size > (1zu << 18);
+
     static constexpr auto get_char_index(char index) noexcept {
       return index_mapping[static_cast<std::size_t>(index)];
     }
@@ -97,13 +213,7 @@ namespace dark::detail {
   private:
     static constexpr auto make_nd_map() noexcept {
       std::array<std::size_t, max_len> stride{1};
-      constexpr auto size = [] {
-        auto size = 1zu;
-        for (auto i = 0zu; i < max_len; ++i) {
-          size *= max_extent;
-        }
-        return size;
-      }();
+      constexpr auto size = table_size;
 
       for (auto i = 1zu; i < max_len; ++i) {
         stride[i] = stride[i - 1] * max_extent;
@@ -126,6 +236,9 @@ namespace dark::detail {
       return res;
     }
 
+    // A variable template so the table, which grows as `max_extent^max_len`,
+    // is only built for Switches that take the table path.
+    template <typename = void>
     static constexpr auto map = Switch::make_nd_map();
 
     /*static auto print(std::size_t const* a, std::size_t const*const s,*/
@@ -148,7 +261,38 @@ namespace dark::detail {
     /**/
     /*}*/
   public:
-       auto match(std::string_view s) const noexcept -> std::size_t {
+      auto match(std::string_view s) const noexcept -> std::size_t {
+        if constexpr (use_swar) {
+          return match_swar(s);
+        } else {
+          return match_table(s);
+        }
+      }
+
+      // Longest match from one 8-byte load; the group of lexemes sharing the
+      // first byte is resolved with masked compares and conditional moves
+      // instead of a per-byte table walk. Lexemes longer than `s` are masked
+      // out so zero padding can never complete them.
+      auto match_swar(std::string_view s) const noexcept -> std::size_t
+        requires swar_capable
+      {
+        if (s.empty()) return npos;
+
+        auto const word = load_word(s);
+        auto const& group = packed_lexems[group_of[word & 0xff]];
+
+        auto found_index = npos;
+        for (auto const& el : group) {
+          // All ones on a hit. Spelled out because GCC turns `hit ? a : b`
+          // back into branches here.
+          auto const select = 0zu - (static_cast<std::size_t>((word & el.mask) == el.value) & static_cast<std::size_t>(el.size <= s.size()));
+          found_index = (el.index & select) | (found_index & ~select);
+        }
+
+        return found_index;
+      }
+
+      auto match_table(std::string_view s) const noexcept -> std::size_t {
         auto size = std::min(max_len, s.size());
 
         auto idx = 0zu;
@@ -157,8 +301,8 @@ namespace dark::detail {
 
         for (auto i = 0zu; i < size; ++i) {
             auto c = get_char_index(s[i]);
-            idx += map.stride[i] * c;
-            auto temp = map.data[idx];
+            idx += map<>.stride[i] * c;
+            auto temp = map<>.data[idx];
             if (temp != npos) found_index = temp;
         }
 
@@ -166,10 +310,23 @@ namespace dark::detail {
       }
 
       constexpr auto match(char c) const noexcept -> std::size_t {
-        auto idx = map.stride[0] * get_char_index(c);
-        return map.data[idx];
+        if constexpr (use_swar) {
+          auto found_index = npos;
+          for (auto const& el : packed_lexems[group_of[static_cast<unsigned char>(c)]]) {
+            if (el.size == 1) found_index = el.index;
+          }
+          return found_index;
+        } else {
+          auto idx = map<>.stride[0] * get_char_index(c);
+          return map<>.data[idx];
+        }
       }
     
+      // True if some lexeme begins with `c`; `match` can only succeed there.
+      constexpr auto can_start(char c) const noexcept -> bool {
+        return start_chars[static_cast<unsigned char>(c)];
+      }
+
       constexpr auto str_from_index(std::size_t index) const noexcept -> std::string_view { return lexems[index].first; }
       constexpr auto token_from_index(std::size_t index) const noexcept -> typename decltype(L0)::tag_t { return lexems[index].second; }
   };
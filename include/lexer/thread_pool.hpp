@@ -0,0 +1,164 @@
+#ifndef DARK_LEXER_THREAD_POOL_HPP
+#define DARK_LEXER_THREAD_POOL_HPP
+
+#include "lexer/hardware.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dark::detail {
+
+    // Runs sets of tasks on `thread_count` workers: the calling thread plus
+    // `thread_count - 1` threads that live as long as the pool and sleep
+    // between `run` calls.
+    //
+    // Tasks are dealt round-robin into per-worker deques in the order given,
+    // so passing them largest first spreads the expensive ones. A worker
+    // drains its own deque from the front; once empty it steals from the
+    // back of the others, taking the cheapest remaining work and leaving the
+    // owner its big items.
+    class WorkStealingPool {
+        struct alignas(cache_line_size) Queue {
+            std::mutex mutex;
+            std::deque<std::size_t> tasks;
+        };
+
+    public:
+        explicit WorkStealingPool(unsigned thread_count)
+            : m_queues(std::max(1u, thread_count))
+        {
+            m_threads.reserve(m_queues.size() - 1);
+            for (auto i = 1zu; i < m_queues.size(); ++i) {
+                m_threads.emplace_back([this, i] { worker(i); });
+            }
+        }
+        WorkStealingPool(WorkStealingPool const&) = delete;
+        WorkStealingPool& operator=(WorkStealingPool const&) = delete;
+        WorkStealingPool(WorkStealingPool &&) = delete;
+        WorkStealingPool& operator=(WorkStealingPool &&) = delete;
+
+        ~WorkStealingPool() {
+            {
+                auto lock = std::lock_guard(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            m_threads.clear();
+        }
+
+        auto thread_count() const noexcept -> unsigned { return static_cast<unsigned>(m_queues.size()); }
+
+        // Blocks until every task has run. Returns the number of steals.
+        // If tasks throw, the rest still run and the first exception is
+        // rethrown here. Must not be called concurrently.
+        auto run(std::vector<std::function<void()>> const& tasks) -> std::size_t {
+            if (tasks.empty()) return 0;
+
+            {
+                auto lock = std::lock_guard(m_mutex);
+                m_tasks = &tasks;
+                m_pending.store(tasks.size(), std::memory_order_relaxed);
+                m_steals.store(0, std::memory_order_relaxed);
+                for (auto i = 0zu; i < tasks.size(); ++i) {
+                    auto& queue = m_queues[i % m_queues.size()];
+                    auto queue_lock = std::lock_guard(queue.mutex);
+                    queue.tasks.push_back(i);
+                }
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            drain(0);
+
+            auto lock = std::unique_lock(m_mutex);
+            m_done.wait(lock, [this] { return m_pending.load(std::memory_order_acquire) == 0; });
+            if (auto error = std::exchange(m_error, nullptr); error != nullptr) {
+                lock.unlock();
+                std::rethrow_exception(error);
+            }
+            return m_steals.load(std::memory_order_relaxed);
+        }
+
+    private:
+        auto worker(std::size_t self) -> void {
+            auto seen = 0zu;
+            while (true) {
+                {
+                    auto lock = std::unique_lock(m_mutex);
+                    m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+                    if (m_stop) return;
+                    seen = m_generation;
+                }
+                drain(self);
+            }
+        }
+
+        // Nothing is enqueued while a run is in progress, so a full sweep
+        // that finds no work means this worker is done with it.
+        auto drain(std::size_t self) -> void {
+            auto const workers = m_queues.size();
+            while (true) {
+                auto task = pop(m_queues[self]);
+                for (auto i = 1zu; !task && i < workers; ++i) {
+                    task = steal(m_queues[(self + i) % workers]);
+                    if (task) m_steals.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (!task) return;
+
+                try {
+                    (*m_tasks)[*task]();
+                } catch (...) {
+                    auto lock = std::lock_guard(m_mutex);
+                    if (m_error == nullptr) m_error = std::current_exception();
+                }
+                if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    { auto lock = std::lock_guard(m_mutex); }
+                    m_done.notify_one();
+                }
+            }
+        }
+
+        static auto pop(Queue& queue) -> std::optional<std::size_t> {
+            auto lock = std::lock_guard(queue.mutex);
+            if (queue.tasks.empty()) return std::nullopt;
+            auto task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return task;
+        }
+
+        static auto steal(Queue& queue) -> std::optional<std::size_t> {
+            auto lock = std::lock_guard(queue.mutex);
+            if (queue.tasks.empty()) return std::nullopt;
+            auto task = queue.tasks.back();
+            queue.tasks.pop_back();
+            return task;
+        }
+
+    private:
+        std::vector<Queue> m_queues;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        std::vector<std::function<void()>> const* m_tasks{nullptr};
+        std::atomic<std::size_t> m_pending{0};
+        std::atomic<std::size_t> m_steals{0};
+        std::exception_ptr m_error{nullptr};
+        std::size_t m_generation{0};
+        bool m_stop{false};
+        // Declared last so the workers are joined before anything they use
+        // is destroyed.
+        std::vector<std::jthread> m_threads;
+    };
+
+} // namespace dark::detail
+
+#endif // DARK_LEXER_THREAD_POOL_HPP
@@ -0,0 +1,165 @@
+#include "test_utils.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <filesystem>
+#include <fstream>
+#include <lexer/parallel.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    template <typename Config>
+    auto same_as_lex(std::string_view source, std::vector<dark::Token<typename Config::kind_t>> const& tokens) -> bool {
+        auto const expected = dark::Lexer<Config>(source).lex();
+        return dark::test::same_tokens(tokens, expected);
+    }
+
+    // Also checks that every file above 1.5 chunks went through the chunked
+    // path and that the small ones were batched rather than run one by one.
+    template <typename Config>
+    auto check_chunked(std::vector<std::string> const& sources, unsigned threads) -> void {
+        auto views = std::vector<std::string_view>(sources.begin(), sources.end());
+        for (auto chunk_size = 5zu; chunk_size <= 7; ++chunk_size) {
+            auto lexer = dark::ParallelLexer<Config>({ .threads = threads, .chunk_size = chunk_size, .batch_size = 16 });
+            auto const result = lexer.lex(std::span<std::string_view const>(views));
+            REQUIRE(result.files.size() == sources.size());
+
+            auto const large = static_cast<std::size_t>(std::ranges::count_if(sources, [&](auto const& s) {
+                return s.size() > chunk_size + chunk_size / 2;
+            }));
+            auto const small = sources.size() - large;
+            INFO("chunk size: " << chunk_size << ", large files: " << large << ", small files: " << small);
+            REQUIRE(result.stats.chunks >= large);
+            REQUIRE(result.stats.split_files <= large);
+            if (large > 0) REQUIRE(result.stats.split_files > 0);
+            REQUIRE(result.stats.tasks >= result.stats.chunks);
+            if (small > 1) REQUIRE(result.stats.tasks - result.stats.chunks < small);
+
+            for (auto i = 0zu; i < sources.size(); ++i) {
+                INFO("chunk size: " << chunk_size << ", source: '" << sources[i] << "'");
+                REQUIRE(result.files[i].source == sources[i]);
+                REQUIRE(same_as_lex<Config>(sources[i], result.files[i].tokens));
+            }
+        }
+    }
+
+} // namespace
+
+TEST_CASE("parallel lexer matches lex() on chunked files", "[parallel]") {
+    auto const sources = std::vector<std::string>{
+        "",
+        "x",
+        "int main() {\n    int a = 3;\n    int b = a * 2;\n}\n",
+        // No '\n' after the first cut.
+        "a\nbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\nb",
+        // Tokens reaching the end of input.
+        "a = 1\nb = 22\nc = 333\nd = 4444\ne = 55555",
+        "a\nb\nc\nd\ne\nf\ng\nh\ni\nj\nidentifier_at_eof",
+        // Tokens crossing every cut.
+        "long_identifier\nlong_identifier\nlong_identifier\n\n\n\n   \n12.5\n",
+        "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n",
+    };
+
+    for (auto threads : { 2u, 3u, 4u }) {
+        check_chunked<dark::DefaultLexerConfig>(sources, threads);
+    }
+}
+
+TEST_CASE("parallel lexer matches lex() on random files", "[parallel]") {
+    auto rng = std::mt19937{99};
+    auto sources = std::vector<std::string>{};
+    auto passthrough = std::vector<std::string>{};
+    for (auto n = 0; n < 200; ++n) {
+        sources.push_back(dark::test::random_source(rng, "ab_ 12.\n\n+->=()", rng() % 120));
+        passthrough.push_back(dark::test::random_source(rng, "ab 1m\n\n\x1b[", rng() % 120));
+    }
+
+    check_chunked<dark::DefaultLexerConfig>(sources, 3);
+    check_chunked<dark::test::PassthroughConfig<>>(passthrough, 3);
+}
+
+TEST_CASE("parallel lexer does not split files on a single thread", "[parallel]") {
+    auto const source = std::string_view{ "a\nb\nc\nd\ne\nf\ng\nh\ni\nj\nk\nl\n" };
+    auto lexer = dark::ParallelLexer<>({ .threads = 1, .chunk_size = 4, .batch_size = 1 });
+    auto const result = lexer.lex(std::span<std::string_view const>(&source, 1));
+
+    REQUIRE(result.stats.split_files == 0);
+    REQUIRE(result.stats.chunks == 0);
+    REQUIRE(same_as_lex<dark::DefaultLexerConfig>(source, result.files[0].tokens));
+}
+
+TEST_CASE("parallel lexer reads files from paths", "[parallel]") {
+    auto const dir = std::filesystem::temp_directory_path() / "dark_parallel_test";
+    std::filesystem::create_directories(dir);
+    auto const contents = std::array<std::string, 2>{ "int a = 1;\n", "x -> y\nz" };
+
+    auto paths = std::vector<std::filesystem::path>{};
+    for (auto i = 0zu; i < contents.size(); ++i) {
+        paths.push_back(dir / ("file_" + std::to_string(i) + ".txt"));
+        std::ofstream(paths.back(), std::ios::binary) << contents[i];
+    }
+    paths.push_back(dir / "missing.txt");
+
+    auto lexer = dark::ParallelLexer<>({ .threads = 2 });
+    // The pool is reused across calls.
+    for (auto run = 0; run < 3; ++run) {
+        auto const result = lexer.lex(std::span<std::filesystem::path const>(paths));
+        REQUIRE(result.files.size() == 3);
+        REQUIRE(result.stats.unreadable_files == 1);
+        REQUIRE_FALSE(result.files[2].ok);
+        REQUIRE(result.files[2].tokens.empty());
+        for (auto i = 0zu; i < contents.size(); ++i) {
+            REQUIRE(result.files[i].ok);
+            REQUIRE(result.files[i].source == contents[i]);
+            REQUIRE(same_as_lex<dark::DefaultLexerConfig>(contents[i], result.files[i].tokens));
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("work-stealing pool runs every task once per run", "[parallel]") {
+    auto pool = dark::detail::WorkStealingPool(4);
+    REQUIRE(pool.thread_count() == 4);
+
+    auto counts = std::vector<std::atomic<int>>(100);
+    auto tasks = std::vector<std::function<void()>>{};
+    for (auto i = 0zu; i < counts.size(); ++i) {
+        tasks.emplace_back([&counts, i] { counts[i].fetch_add(1); });
+    }
+
+    for (auto run = 1; run <= 5; ++run) {
+        pool.run(tasks);
+        for (auto const& c : counts) REQUIRE(c.load() == run);
+    }
+    REQUIRE(pool.run({}) == 0);
+}
+
+TEST_CASE("work-stealing pool rethrows the first task exception", "[parallel]") {
+    auto pool = dark::detail::WorkStealingPool(3);
+
+    auto counts = std::vector<std::atomic<int>>(30);
+    auto tasks = std::vector<std::function<void()>>{};
+    for (auto i = 0zu; i < counts.size(); ++i) {
+        tasks.emplace_back([&counts, i] {
+            counts[i].fetch_add(1);
+            if (i % 7 == 3) throw std::runtime_error("task " + std::to_string(i));
+        });
+    }
+
+    // Tasks are dealt round-robin, so both the caller and the workers throw.
+    REQUIRE_THROWS_AS(pool.run(tasks), std::runtime_error);
+    for (auto const& c : counts) REQUIRE(c.load() == 1);
+
+    // The error is consumed by the run that reported it.
+    tasks.erase(tasks.begin() + 3, tasks.end());
+    pool.run(tasks);
+    REQUIRE(counts[0].load() == 2);
+    REQUIRE(counts[2].load() == 2);
+}
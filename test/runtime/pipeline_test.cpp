@@ -0,0 +1,110 @@
+#include "test_utils.hpp"
+#include <catch2/catch.hpp>
+#include <lexer/pipeline.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using dark::test::same_tokens;
+
+    using token_t = dark::Token<dark::DefaultTokenKind>;
+
+    auto make_source(std::size_t lines) -> std::string {
+        auto source = std::string{};
+        for (auto i = 0zu; i < lines; ++i) {
+            source += "int a" + std::to_string(i) + " = b * (c + 42) -> d;\n";
+        }
+        return source;
+    }
+
+    template <std::size_t BatchSize, std::size_t RingSize>
+    auto drain(std::string_view source) -> std::vector<token_t> {
+        auto lexer = dark::PipelinedLexer<dark::DefaultLexerConfig, BatchSize, RingSize>(source);
+        auto tokens = std::vector<token_t>{};
+        for (auto const& t : lexer) tokens.push_back(t);
+        REQUIRE(lexer.is_finished());
+        return tokens;
+    }
+
+    // Cuts the source so the token count, `Eof` included, lands exactly on,
+    // just before and just after a multiple of `BatchSize`. Cutting right
+    // before token `m` keeps tokens `0..m-1` intact and adds `Eof`.
+    template <std::size_t BatchSize, std::size_t RingSize>
+    auto check_batch_boundaries(std::string_view source, std::vector<token_t> const& expected) -> void {
+        auto const multiple = (expected.size() - 1) / BatchSize * BatchSize;
+        REQUIRE(multiple > 1);
+        for (auto count : { multiple - 1, multiple, multiple + 1 }) {
+            auto const prefix = source.substr(0, expected[count - 1].start);
+            auto const reference = dark::Lexer<>(prefix).lex();
+            INFO("batch size: " << BatchSize << ", tokens: " << count);
+            REQUIRE(reference.size() == count);
+            REQUIRE(same_tokens(drain<BatchSize, RingSize>(prefix), reference));
+        }
+    }
+
+} // namespace
+
+TEST_CASE("pipelined lexer matches lex() across batch boundaries", "[pipeline]") {
+    auto const source = make_source(20);
+    auto const expected = dark::Lexer<>(source).lex();
+
+    check_batch_boundaries<1, 1>(source, expected);
+    check_batch_boundaries<4, 2>(source, expected);
+    check_batch_boundaries<7, 4>(source, expected);
+    check_batch_boundaries<256, 16>(source, expected);
+
+    REQUIRE(same_tokens(drain<8, 2>(""), dark::Lexer<>("").lex()));
+}
+
+TEST_CASE("pipelined lexer batches match lex() when polled", "[pipeline]") {
+    auto const source = make_source(50);
+    auto const expected = dark::Lexer<>(source).lex();
+
+    auto lexer = dark::PipelinedLexer<dark::DefaultLexerConfig, 16, 4>(source);
+    auto tokens = std::vector<token_t>{};
+    while (!lexer.is_finished()) {
+        auto batch = lexer.try_pop_batch();
+        if (batch == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        REQUIRE(batch->size > 0);
+        REQUIRE((batch->size == 16 || batch->is_last));
+        tokens.insert(tokens.end(), batch->begin(), batch->end());
+        lexer.release_batch(batch);
+    }
+
+    REQUIRE(lexer.try_pop_batch() == nullptr);
+    REQUIRE(lexer.pop_batch() == nullptr);
+    REQUIRE(same_tokens(tokens, expected));
+}
+
+TEST_CASE("pipelined lexer can be destroyed early", "[pipeline]") {
+    auto const source = make_source(2000);
+
+    SECTION("before anything is consumed") {
+        auto lexer = dark::PipelinedLexer<dark::DefaultLexerConfig, 1, 2>(source);
+    }
+
+    SECTION("while the producer is blocked on a full ring") {
+        auto lexer = dark::PipelinedLexer<dark::DefaultLexerConfig, 1, 2>(source);
+        auto batch = lexer.pop_batch();
+        REQUIRE(batch != nullptr);
+        REQUIRE(batch->tokens[0].kind == dark::DefaultTokenKind::Identifier);
+        lexer.release_batch(batch);
+        // Give the producer time to fill the ring and park.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    SECTION("after a partial range-for") {
+        auto lexer = dark::PipelinedLexer<dark::DefaultLexerConfig, 8, 2>(source);
+        auto count = 0zu;
+        for (auto const& t : lexer) {
+            (void)t;
+            if (++count == 100) break;
+        }
+        REQUIRE(count == 100);
+    }
+}
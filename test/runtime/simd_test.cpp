@@ -0,0 +1,153 @@
+#include <catch2/catch.hpp>
+#include <lexer/simd.hpp>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace {
+
+    using dark::detail::simd::ByteSet;
+    using dark::detail::simd::find_first_of;
+
+    template <std::size_t N>
+    auto naive_find(ByteSet<N> const& set, std::string_view s) -> std::size_t {
+        for (auto i = 0zu; i < s.size(); ++i) {
+            if (set.contains(s[i])) return i;
+        }
+        return s.size();
+    }
+
+    // A single member at every position of every length up to a few vector
+    // blocks, so hits land in the vector loop and in the scalar tail alike.
+    template <std::size_t N>
+    auto check_positions(ByteSet<N> const& set, char member, char other) -> void {
+        for (auto len = 0zu; len < 80; ++len) {
+            auto s = std::string(len, other);
+            REQUIRE(find_first_of(set, s) == len);
+            for (auto pos = 0zu; pos < len; ++pos) {
+                s[pos] = member;
+                INFO("len: " << len << ", pos: " << pos);
+                REQUIRE(find_first_of(set, s) == pos);
+                s[pos] = other;
+            }
+        }
+    }
+
+    template <std::size_t N>
+    auto check_random(ByteSet<N> const& set) -> void {
+        auto rng = std::mt19937{7};
+        for (auto n = 0; n < 20000; ++n) {
+            auto s = std::string(rng() % 70, '\0');
+            for (auto& c : s) {
+                // Mostly non-members so hits are spread over the whole string.
+                c = static_cast<char>(rng() % 256);
+                if (set.contains(c) && rng() % 8 != 0) c = 'a';
+            }
+            INFO("len: " << s.size());
+            REQUIRE(find_first_of(set, s) == naive_find(set, s));
+        }
+    }
+
+} // namespace
+
+TEST_CASE("find_first_of agrees with a scalar search", "[simd]") {
+    SECTION("single byte") {
+        constexpr auto set = ByteSet<1>("\x1b");
+        check_positions(set, '\x1b', 'a');
+        check_random(set);
+    }
+
+    SECTION("escape sequence introducers") {
+        constexpr auto set = ByteSet<2>("\x1b\\");
+        check_positions(set, '\\', 'm');
+        check_positions(set, '\x1b', '[');
+        check_random(set);
+    }
+
+    SECTION("bytes with the high bit set") {
+        constexpr auto set = ByteSet<3>("\x80\xff\x0f");
+        check_positions(set, '\xff', '\x7f');
+        check_positions(set, '\x80', '\x8f');
+        check_random(set);
+    }
+
+    SECTION("many high nibbles sharing one row") {
+        constexpr auto set = ByteSet<10>("\x01\x11\x21\x31\x41\x51\x61\x71\x81\x91");
+        REQUIRE(set.nibbles.exact);
+        check_positions(set, '\x61', '\x62');
+        check_random(set);
+    }
+
+    SECTION("more than eight distinct rows") {
+        constexpr auto set = ByteSet<9>("\x01\x12\x23\x34\x45\x56\x67\x78\x89");
+        REQUIRE_FALSE(set.nibbles.exact);
+        check_positions(set, '\x67', '\x66');
+        check_random(set);
+    }
+
+    SECTION("many bytes sharing nibbles") {
+        constexpr auto set = ByteSet<15>("\x1b\\0123456789:;m");
+        REQUIRE(set.nibbles.exact);
+        check_positions(set, '7', 'n');
+        check_positions(set, 'm', '<');
+        check_random(set);
+    }
+}
+
+TEST_CASE("count_byte agrees with a scalar count", "[simd]") {
+    auto rng = std::mt19937{11};
+    for (auto n = 0; n < 5000; ++n) {
+        auto s = std::string(rng() % 200, 'a');
+        for (auto& c : s) {
+            if (rng() % 16 == 0) c = '\n';
+        }
+
+        auto count = 0zu;
+        auto last = std::string_view::npos;
+        for (auto i = 0zu; i < s.size(); ++i) {
+            if (s[i] != '\n') continue;
+            ++count;
+            last = i;
+        }
+
+        auto const res = dark::detail::simd::count_byte('\n', s);
+        INFO("len: " << s.size());
+        REQUIRE(res.count == count);
+        REQUIRE(res.last == last);
+    }
+
+    REQUIRE(dark::detail::simd::count_byte('\n', std::string_view{}).count == 0);
+    REQUIRE(dark::detail::simd::count_byte('\n', std::string(64, '\n')).last == 63);
+}
+
+TEST_CASE("nibble tables split byte sets exactly", "[simd]") {
+    auto rng = std::mt19937{5};
+    auto inexact = 0;
+    for (auto n = 0; n < 2000; ++n) {
+        // Few distinct rows repeated under random high nibbles, so most sets
+        // are splittable and some are not.
+        auto rows = std::array<std::uint16_t, 10>{};
+        for (auto& row : rows) row = static_cast<std::uint16_t>(rng());
+
+        auto members = std::array<bool, 256>{};
+        for (auto h = 0zu; h < 16; ++h) {
+            auto const row = rng() % 3 == 0 ? std::uint16_t{0} : rows[rng() % (1 + n % rows.size())];
+            for (auto l = 0zu; l < 16; ++l) members[h * 16 + l] = (row >> l) & 1;
+        }
+
+        auto const table = dark::detail::simd::NibbleTable(members);
+        if (!table.exact) {
+            ++inexact;
+            continue;
+        }
+        auto mismatches = 0zu;
+        for (auto b = 0zu; b < 256; ++b) {
+            mismatches += ((table.low[b & 15] & table.high[b >> 4]) != 0) != members[b];
+        }
+        REQUIRE(mismatches == 0);
+    }
+    REQUIRE(inexact > 0);
+    REQUIRE(inexact < 2000);
+}
@@ -0,0 +1,69 @@
+#include "test_utils.hpp"
+#include <catch2/catch.hpp>
+#include <lexer.hpp>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace {
+
+    struct StructuralConfig : dark::DefaultLexerConfig {
+        static constexpr auto engine = dark::LexerEngine::StructuralIndex;
+    };
+
+    template <typename Sequential, typename Structural>
+    auto check(std::string_view source) -> void {
+        auto const expected = dark::Lexer<Sequential>(source).lex();
+        auto const tokens = dark::Lexer<Structural>(source).lex();
+        INFO("source: '" << source << "' (" << source.size() << " bytes)");
+        REQUIRE(tokens.size() == expected.size());
+        REQUIRE(dark::test::same_tokens(tokens, expected));
+    }
+
+    auto check_default(std::string_view source) -> void {
+        check<dark::DefaultLexerConfig, StructuralConfig>(source);
+    }
+
+    auto check_passthrough(std::string_view source) -> void {
+        check<dark::test::PassthroughConfig<dark::LexerEngine::Sequential>, dark::test::PassthroughConfig<dark::LexerEngine::StructuralIndex>>(source);
+    }
+
+} // namespace
+
+TEST_CASE("structural index matches lex() on identifier runs across block edges", "[structural]") {
+    for (auto offset = 0zu; offset < 70; ++offset) {
+        for (auto len : { 1zu, 2zu, 63zu, 64zu, 65zu, 127zu, 128zu, 129zu, 200zu }) {
+            auto const prefix = std::string(offset, ' ');
+            auto const ident = std::string(len, 'a');
+            check_default(prefix + ident);
+            check_default(prefix + ident + " = 1;");
+            check_default(prefix + "_" + ident + "(x)\n");
+        }
+    }
+}
+
+TEST_CASE("structural index matches lex() on block-sized inputs", "[structural]") {
+    for (auto blocks = 1zu; blocks <= 3; ++blocks) {
+        auto const size = blocks * 64;
+        check_default(std::string(size, 'x'));
+        check_default(std::string(size, ' '));
+        check_default(std::string(size - 1, 'x') + "+");
+        check_default(std::string(size - 2, ' ') + "->");
+        check_default(std::string(size - 3, ' ') + "123");
+
+        check_passthrough(std::string(size, 'z'));
+        check_passthrough(std::string(size - 3, 'z') + "\x1b[m");
+        check_passthrough("\x1b[m" + std::string(size - 3, 'z'));
+    }
+    check_default("");
+    check_passthrough("");
+}
+
+TEST_CASE("structural index matches lex() on random sources", "[structural]") {
+    auto rng = std::mt19937{1234};
+    for (auto n = 0; n < 2000; ++n) {
+        auto const size = rng() % 300;
+        check_default(dark::test::random_source(rng, "abc_$XY 019.\n+-><=!&|()[]{};,?#", size));
+        check_passthrough(dark::test::random_source(rng, "azm 1;\n\x1b[\x1b", size));
+    }
+}
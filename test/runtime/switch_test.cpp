@@ -0,0 +1,147 @@
+#include <catch2/catch.hpp>
+#include <lexer.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    enum class Tag { A, B, C, D, E, F, G };
+
+    using dark::detail::Case;
+    using dark::detail::Switch;
+
+    constexpr auto overlapping = Switch<
+        Case(Tag::A, "-"),
+        Case(Tag::B, "->"),
+        Case(Tag::C, "="),
+        Case(Tag::D, "=>"),
+        Case(Tag::E, "int"),
+        Case(Tag::F, "int8")
+    >{};
+
+    constexpr auto duplicates = Switch<
+        Case(Tag::A, "=="),
+        Case(Tag::B, "="),
+        Case(Tag::C, "==")
+    >{};
+
+    constexpr auto word_sized = Switch<
+        Case(Tag::A, "i"),
+        Case(Tag::B, "in"),
+        Case(Tag::C, "int"),
+        Case(Tag::D, "int32"),
+        Case(Tag::E, "interval"),
+        Case(Tag::F, "inter"),
+        Case(Tag::G, "\x1b[")
+    >{};
+
+    // Every lexeme, every prefix of one, and random ASCII strings biased
+    // towards the Switch's own bytes.
+    auto make_inputs(std::vector<std::string_view> const& lexems) -> std::vector<std::string> {
+        auto inputs = std::vector<std::string>{ "" };
+        auto alphabet = std::string{ "xyz \n0" };
+        for (auto el : lexems) {
+            alphabet += el;
+            for (auto i = 0zu; i <= el.size(); ++i) {
+                inputs.emplace_back(el.substr(0, i));
+                inputs.emplace_back(std::string(el.substr(0, i)) + "x");
+                inputs.emplace_back(std::string(el) + std::string(el.substr(0, i)));
+            }
+        }
+
+        auto rng = std::mt19937{42};
+        for (auto n = 0; n < 20000; ++n) {
+            auto s = std::string{};
+            auto const len = rng() % 12;
+            for (auto i = 0zu; i < len; ++i) {
+                s += alphabet[rng() % alphabet.size()];
+            }
+            inputs.push_back(std::move(s));
+        }
+        return inputs;
+    }
+
+    template <typename S>
+    auto lexems_of(S const& sw, std::size_t count) -> std::vector<std::string_view> {
+        auto res = std::vector<std::string_view>{};
+        for (auto i = 0zu; i < count; ++i) res.push_back(sw.str_from_index(i));
+        return res;
+    }
+
+    // Reference longest-prefix match; on equal strings the later case wins.
+    auto naive_match(std::vector<std::string_view> const& lexems, std::string_view s) -> std::size_t {
+        auto found = std::numeric_limits<std::size_t>::max();
+        auto found_len = 0zu;
+        for (auto i = 0zu; i < lexems.size(); ++i) {
+            if (s.starts_with(lexems[i]) && (found == std::numeric_limits<std::size_t>::max() || lexems[i].size() >= found_len)) {
+                found = i;
+                found_len = lexems[i].size();
+            }
+        }
+        return found;
+    }
+
+} // namespace
+
+TEST_CASE("SWAR match agrees with the table match", "[switch]") {
+    SECTION("overlapping lexemes") {
+        for (auto const& s : make_inputs(lexems_of(overlapping, 6))) {
+            INFO("input: '" << s << "'");
+            REQUIRE(overlapping.match_swar(s) == overlapping.match_table(s));
+        }
+    }
+
+    SECTION("duplicate lexemes") {
+        for (auto const& s : make_inputs(lexems_of(duplicates, 3))) {
+            INFO("input: '" << s << "'");
+            REQUIRE(duplicates.match_swar(s) == duplicates.match_table(s));
+        }
+    }
+
+    SECTION("default config") {
+        constexpr auto const& ops = dark::DefaultLexerConfig::operators;
+        for (auto const& s : make_inputs(lexems_of(ops, 20))) {
+            INFO("input: '" << s << "'");
+            REQUIRE(ops.match_swar(s) == ops.match_table(s));
+        }
+
+        constexpr auto const& puncts = dark::DefaultLexerConfig::punctuations;
+        for (auto const& s : make_inputs(lexems_of(puncts, 10))) {
+            INFO("input: '" << s << "'");
+            REQUIRE(puncts.match_swar(s) == puncts.match_table(s));
+        }
+    }
+}
+
+TEST_CASE("SWAR match handles word-sized lexemes", "[switch]") {
+    auto const lexems = lexems_of(word_sized, 7);
+    for (auto const& s : make_inputs(lexems)) {
+        INFO("input: '" << s << "'");
+        REQUIRE(word_sized.match(s) == naive_match(lexems, s));
+    }
+
+    // Bytes past the view must not take part in the match.
+    auto const buffer = std::string_view{ "interval" };
+    REQUIRE(word_sized.match(buffer.substr(0, 5)) == 5);
+    REQUIRE(word_sized.match(buffer.substr(0, 4)) == 2);
+}
+
+TEST_CASE("single character match agrees with the table match", "[switch]") {
+    for (auto c = 0; c < 128; ++c) {
+        auto const ch = static_cast<char>(c);
+        REQUIRE(overlapping.match(ch) == overlapping.match_table(std::string_view(&ch, 1)));
+        REQUIRE(dark::DefaultLexerConfig::operators.match(ch) == dark::DefaultLexerConfig::operators.match_table(std::string_view(&ch, 1)));
+    }
+}
+
+TEST_CASE("empty input never matches", "[switch]") {
+    for (auto s : { std::string_view{}, std::string_view{""} }) {
+        REQUIRE(overlapping.match(s) == overlapping.npos);
+        REQUIRE(overlapping.match_swar(s) == overlapping.match_table(s));
+        REQUIRE(duplicates.match_swar(s) == duplicates.match_table(s));
+        REQUIRE(word_sized.match(s) == word_sized.npos);
+        REQUIRE(dark::DefaultLexerConfig::operators.match_swar(s) == dark::DefaultLexerConfig::operators.match_table(s));
+        REQUIRE(dark::DefaultLexerConfig::punctuations.match_swar(s) == dark::DefaultLexerConfig::punctuations.match_table(s));
+    }
+}
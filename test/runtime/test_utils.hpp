@@ -0,0 +1,73 @@
+#ifndef DARK_TEST_RUNTIME_TEST_UTILS_HPP
+#define DARK_TEST_RUNTIME_TEST_UTILS_HPP
+
+#include <algorithm>
+#include <array>
+#include <lexer.hpp>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dark::test {
+
+    template <typename Kind>
+    auto same_tokens(std::vector<Token<Kind>> const& lhs, std::vector<Token<Kind>> const& rhs) -> bool {
+        return std::ranges::equal(lhs, rhs, [](Token<Kind> const& l, Token<Kind> const& r) {
+            return l.kind == r.kind && l.text == r.text && l.start == r.start && l.line == r.line && l.col == r.col;
+        });
+    }
+
+    inline auto random_source(std::mt19937& rng, std::string_view alphabet, std::size_t size) -> std::string {
+        auto s = std::string(size, ' ');
+        for (auto& c : s) c = alphabet[rng() % alphabet.size()];
+        return s;
+    }
+
+    enum class PassthroughKind {
+        EscapeSequence,
+        SemiColon,
+        EndCharacter,
+        Number,
+        Identifier,
+        Text,
+        Unknown,
+        Eof
+    };
+
+    // Terminal-output style config: ESC and '\\' open escape sequences that
+    // end at 'm'; identifiers (`a`-`l`) and numbers only occur inside them.
+    template <LexerEngine Engine = LexerEngine::Sequential>
+    struct PassthroughConfig {
+        using kind_t = PassthroughKind;
+        static constexpr auto engine = Engine;
+
+        static constexpr std::string_view text_triggers = "\x1b\\";
+        static constexpr auto sequence_terminators = std::array{ PassthroughKind::EndCharacter };
+
+        static constexpr auto punctuations = detail::Switch<
+            detail::Case(PassthroughKind::EscapeSequence, "\\x1b["),
+            detail::Case(PassthroughKind::EscapeSequence, "\x1b["),
+            detail::Case(PassthroughKind::SemiColon, ";"),
+            detail::Case(PassthroughKind::EndCharacter, "m")
+        >{};
+
+        static constexpr auto is_valid_identifier_start(std::string_view s) noexcept -> bool {
+            return s[0] >= 'a' && s[0] <= 'l';
+        }
+        static constexpr auto is_valid_identifier(std::string_view s) noexcept -> bool {
+            return is_valid_identifier_start(s);
+        }
+        static constexpr auto is_digit(std::string_view s) noexcept -> bool {
+            return DefaultLexerConfig::is_digit(s);
+        }
+        static constexpr auto parse_number(std::string_view s) noexcept -> std::string_view {
+            auto c = 0zu;
+            while (c < s.size() && is_digit(s.substr(c))) ++c;
+            return s.substr(0, c);
+        }
+    };
+
+} // namespace dark::test
+
+#endif // DARK_TEST_RUNTIME_TEST_UTILS_HPP
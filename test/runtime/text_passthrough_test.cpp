@@ -0,0 +1,92 @@
+#include "test_utils.hpp"
+#include <catch2/catch.hpp>
+#include <lexer.hpp>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    using Kind = dark::test::PassthroughKind;
+    using PassthroughConfig = dark::test::PassthroughConfig<>;
+
+    struct Expected {
+        Kind kind;
+        std::string_view text;
+        unsigned line;
+        unsigned col;
+    };
+
+    auto check(std::string_view source, std::vector<Expected> const& expected) -> void {
+        auto const tokens = dark::Lexer<PassthroughConfig>(source).lex();
+        REQUIRE(tokens.size() == expected.size());
+        for (auto i = 0zu; i < tokens.size(); ++i) {
+            INFO("token " << i << ": '" << tokens[i].text << "'");
+            REQUIRE(tokens[i].kind == expected[i].kind);
+            REQUIRE(tokens[i].text == expected[i].text);
+            REQUIRE(tokens[i].line == expected[i].line);
+            REQUIRE(tokens[i].col == expected[i].col);
+        }
+    }
+
+} // namespace
+
+TEST_CASE("plain text is a single token", "[text_passthrough]") {
+    // Digits and 'm' only start tokens inside a sequence.
+    check("I'm at room 42\nmore text", {
+        { Kind::Text, "I'm at room 42\nmore text", 0, 0 },
+        { Kind::Eof, "", 1, 10 },
+    });
+
+    check("", {
+        { Kind::Eof, "", 0, 0 },
+    });
+}
+
+TEST_CASE("multi-line text keeps line and column after the span", "[text_passthrough]") {
+    check("ab\ncd\nef\x1b[1m\nx", {
+        { Kind::Text, "ab\ncd\nef", 0, 0 },
+        { Kind::EscapeSequence, "\x1b[", 2, 3 },
+        { Kind::Number, "1", 2, 5 },
+        { Kind::EndCharacter, "m", 2, 6 },
+        { Kind::Text, "\nx", 3, 0 },
+        { Kind::Eof, "", 3, 2 },
+    });
+}
+
+TEST_CASE("sequences are lexed until their terminator", "[text_passthrough]") {
+    check("\\x1b[1;31mred 1m\\x1b[0m", {
+        { Kind::EscapeSequence, "\\x1b[", 0, 0 },
+        { Kind::Number, "1", 0, 5 },
+        { Kind::SemiColon, ";", 0, 6 },
+        { Kind::Number, "31", 0, 7 },
+        { Kind::EndCharacter, "m", 0, 9 },
+        { Kind::Text, "red 1m", 0, 10 },
+        { Kind::EscapeSequence, "\\x1b[", 0, 16 },
+        { Kind::Number, "0", 0, 21 },
+        { Kind::EndCharacter, "m", 0, 22 },
+        { Kind::Eof, "", 0, 23 },
+    });
+}
+
+TEST_CASE("text reaching the end of input", "[text_passthrough]") {
+    check("\x1b[m tail 42", {
+        { Kind::EscapeSequence, "\x1b[", 0, 0 },
+        { Kind::EndCharacter, "m", 0, 2 },
+        { Kind::Text, " tail 42", 0, 3 },
+        { Kind::Eof, "", 0, 11 },
+    });
+}
+
+TEST_CASE("malformed sequences fall back to text", "[text_passthrough]") {
+    // A lone trigger and an unexpected byte inside a sequence both end it.
+    check("a\\b\x1b[2x 3;", {
+        { Kind::Text, "a", 0, 0 },
+        { Kind::Unknown, "\\", 0, 1 },
+        { Kind::Text, "b", 0, 2 },
+        { Kind::EscapeSequence, "\x1b[", 0, 3 },
+        { Kind::Number, "2", 0, 5 },
+        { Kind::Unknown, "x", 0, 6 },
+        { Kind::Text, " 3;", 0, 7 },
+        { Kind::Eof, "", 0, 10 },
+    });
+}